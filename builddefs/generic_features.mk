@@ -29,8 +29,12 @@ GENERIC_FEATURES = \
     HAPTIC \
     KEY_LOCK \
     KEY_OVERRIDE \
+    LATENCY_TRACE \
     LEADER \
+    POINTING_DEVICE_ACCEL \
+    POINTING_DEVICE_MODES \
     PROGRAMMABLE_BUTTON \
+    SCAN_PROFILER \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
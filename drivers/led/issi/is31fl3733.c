@@ -84,6 +84,33 @@ bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
 
+#ifdef I2C_QUEUE_ENABLE
+// Set from the I2C queue thread when a transfer queued for a driver fails
+static volatile bool g_queued_transfer_failed[DRIVER_COUNT] = {false};
+// The driver transfers are being queued for, DRIVER_COUNT when the caller only gave its address
+static uint8_t g_queued_transfer_driver = DRIVER_COUNT;
+
+static void IS31FL3733_queued_transfer_done(i2c_status_t status, void *arg) {
+    if (status != I2C_STATUS_SUCCESS) {
+        uint8_t index = (uintptr_t)arg;
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            if (index == i || index == DRIVER_COUNT) {
+                g_queued_transfer_failed[i] = true;
+            }
+        }
+    }
+}
+#endif
+
+static bool IS31FL3733_transmit(uint8_t addr, uint8_t length) {
+#ifdef I2C_QUEUE_ENABLE
+    // The queue copies g_twi_transfer_buffer, failures are reported to IS31FL3733_queued_transfer_done()
+    return i2c_queue_transmit(addr << 1, g_twi_transfer_buffer, length, ISSI_TIMEOUT, IS31FL3733_queued_transfer_done, (void *)(uintptr_t)g_queued_transfer_driver) == I2C_STATUS_SUCCESS;
+#else
+    return i2c_transmit(addr << 1, g_twi_transfer_buffer, length, ISSI_TIMEOUT) == I2C_STATUS_SUCCESS;
+#endif
+}
+
 bool IS31FL3733_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     // If the transaction fails function returns false.
     g_twi_transfer_buffer[0] = reg;
@@ -91,12 +118,12 @@ bool IS31FL3733_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 
 #if ISSI_PERSISTENCE > 0
     for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 2, ISSI_TIMEOUT) != 0) {
+        if (!IS31FL3733_transmit(addr, 2)) {
             return false;
         }
     }
 #else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 2, ISSI_TIMEOUT) != 0) {
+    if (!IS31FL3733_transmit(addr, 2)) {
         return false;
     }
 #endif
@@ -121,12 +148,12 @@ bool IS31FL3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
 
 #if ISSI_PERSISTENCE > 0
         for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
+            if (!IS31FL3733_transmit(addr, 17)) {
                 return false;
             }
         }
 #else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
+        if (!IS31FL3733_transmit(addr, 17)) {
             return false;
         }
 #endif
@@ -175,6 +202,10 @@ void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     IS31FL3733_write_register(addr, ISSI_REG_GLOBALCURRENT, 0xFF);
     // Disable software shutdown.
     IS31FL3733_write_register(addr, ISSI_REG_CONFIGURATION, ((sync & 0b11) << 6) | ((ISSI_PWM_FREQUENCY & 0b111) << 3) | 0x01);
+#ifdef I2C_QUEUE_ENABLE
+    // Make sure the device is out of shutdown before waiting for it
+    i2c_queue_flush();
+#endif
 
     // Wait 10ms to ensure the device has woken up.
     wait_ms(10);
@@ -229,6 +260,15 @@ void IS31FL3733_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
+#ifdef I2C_QUEUE_ENABLE
+    // A transfer queued by a previous update of this driver failed, resend everything just in case
+    if (g_queued_transfer_failed[index]) {
+        g_queued_transfer_failed[index]                = false;
+        g_pwm_buffer_update_required[index]            = true;
+        g_led_control_registers_update_required[index] = true;
+    }
+    g_queued_transfer_driver = index;
+#endif
     if (g_pwm_buffer_update_required[index]) {
         // Firstly we need to unlock the command register and select PG1.
         IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
@@ -241,9 +281,15 @@ void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
         }
     }
     g_pwm_buffer_update_required[index] = false;
+#ifdef I2C_QUEUE_ENABLE
+    g_queued_transfer_driver = DRIVER_COUNT;
+#endif
 }
 
 void IS31FL3733_update_led_control_registers(uint8_t addr, uint8_t index) {
+#ifdef I2C_QUEUE_ENABLE
+    g_queued_transfer_driver = index;
+#endif
     if (g_led_control_registers_update_required[index]) {
         // Firstly we need to unlock the command register and select PG0
         IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
@@ -253,4 +299,7 @@ void IS31FL3733_update_led_control_registers(uint8_t addr, uint8_t index) {
         }
     }
     g_led_control_registers_update_required[index] = false;
+#ifdef I2C_QUEUE_ENABLE
+    g_queued_transfer_driver = DRIVER_COUNT;
+#endif
 }
@@ -101,7 +101,31 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define I2C_TRANSMIT_P(data) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
 #endif // defined(__AVR__)
 #define I2C_TRANSMIT(data) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), &data[0], sizeof(data), OLED_I2C_TIMEOUT)
-#define I2C_WRITE_REG(mode, data, size) i2c_writeReg((OLED_DISPLAY_ADDRESS << 1), mode, data, size, OLED_I2C_TIMEOUT)
+// Control byte of a single command byte, followed by another control byte
+#define I2C_CMD_CONTINUED 0x80
+#ifdef I2C_QUEUE_ENABLE
+// oled_render() copies the spans into the I2C queue and returns without waiting for the bus
+#    define I2C_RENDER_TRANSMIT(data, size) i2c_queue_transmit((OLED_DISPLAY_ADDRESS << 1), data, size, OLED_I2C_TIMEOUT, oled_render_done, NULL)
+#else
+#    define I2C_RENDER_TRANSMIT(data, size) i2c_transmit((OLED_DISPLAY_ADDRESS << 1), data, size, OLED_I2C_TIMEOUT)
+#endif
+
+// Addressing commands, each one preceded by its control byte, then the control byte of the span data
+#define OLED_SPAN_HEADER_SIZE 13
+
+// Most dirty blocks sent by one oled_render() call, by default those of a page of the display
+#ifndef OLED_SPAN_BLOCKS
+#    ifdef I2C_QUEUE_ENABLE
+#        define OLED_SPAN_MAX_SIZE (I2C_QUEUE_TRANSFER_SIZE - OLED_SPAN_HEADER_SIZE)
+#    else
+#        define OLED_SPAN_MAX_SIZE OLED_DISPLAY_WIDTH
+#    endif
+#    define OLED_SPAN_BLOCKS (OLED_BLOCK_SIZE < OLED_SPAN_MAX_SIZE ? OLED_SPAN_MAX_SIZE / OLED_BLOCK_SIZE : 1)
+#endif
+
+#ifdef I2C_QUEUE_ENABLE
+_Static_assert(OLED_SPAN_HEADER_SIZE + OLED_SPAN_BLOCKS * OLED_BLOCK_SIZE <= I2C_QUEUE_TRANSFER_SIZE, "I2C_QUEUE_TRANSFER_SIZE is too small for an OLED span, every oled_render() would wait for the bus");
+#endif
 
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
 
@@ -245,7 +269,7 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds(uint8_t update_start, uint8_t update_count, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
     uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
     uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
@@ -260,19 +284,53 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     cmd_array[5] = NOP;
 #else
     // Commands for use in Horizontal Addressing mode.
-    cmd_array[1] = start_column;
-    cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    uint16_t update_size = OLED_BLOCK_SIZE * update_count;
+    cmd_array[1]         = start_column;
+    cmd_array[4]         = start_page;
+    cmd_array[2]         = (update_size + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
+    cmd_array[5]         = (update_size + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
 #endif
 }
 
-static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
-    cmd_array[1] = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
-    cmd_array[4] = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
-    ;
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
+static void calc_bounds_90(uint8_t update_start, uint8_t update_count, uint8_t *cmd_array) {
+    uint16_t update_size = OLED_BLOCK_SIZE * update_count;
+    cmd_array[1]         = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
+    cmd_array[4]         = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT;
+    cmd_array[2]         = (update_size + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
+    cmd_array[5]         = (update_size + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
+}
+
+// Counts the dirty blocks from update_start that the display can take as a single rectangle
+static uint8_t calc_span(uint8_t update_start) {
+    uint8_t max_count = OLED_SPAN_BLOCKS;
+    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+        // Only whole pages follow each other in the display memory, so a span stays within its page
+        if (OLED_BLOCK_SIZE >= OLED_DISPLAY_WIDTH || OLED_DISPLAY_WIDTH % OLED_BLOCK_SIZE) {
+            return 1;
+        }
+        uint8_t page_blocks = OLED_DISPLAY_WIDTH / OLED_BLOCK_SIZE;
+        if (max_count > page_blocks - update_start % page_blocks) {
+            max_count = page_blocks - update_start % page_blocks;
+        }
+    } else if (OLED_BLOCK_SIZE % OLED_DISPLAY_HEIGHT) {
+        // Rotated blocks only sit side by side when each one covers the full height of the display
+        return 1;
+    }
+
+    uint8_t update_count = 1;
+    while (update_count < max_count && update_start + update_count < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << (update_start + update_count)))) {
+        ++update_count;
+    }
+    return update_count;
+}
+
+// Offset of a rotated byte of the given block within a span of update_count blocks side by side
+static uint16_t span_offset_90(uint8_t target, uint8_t block, uint8_t update_count) {
+    if (update_count == 1) {
+        return target;
+    }
+    uint8_t block_width = OLED_BLOCK_SIZE / OLED_DISPLAY_HEIGHT * 8;
+    return target / block_width * block_width * update_count + block * block_width + target % block_width;
 }
 
 uint8_t crot(uint8_t a, int8_t n) {
@@ -290,66 +348,86 @@ static void rotate_90(const uint8_t *src, uint8_t *dest) {
     }
 }
 
+#ifdef I2C_QUEUE_ENABLE
+// Set from the I2C queue thread when a render transfer fails
+static volatile bool oled_render_failed = false;
+
+static void oled_render_done(i2c_status_t status, void *arg) {
+    if (status != I2C_STATUS_SUCCESS) {
+        oled_render_failed = true;
+    }
+}
+#endif
+
 void oled_render(void) {
     if (!oled_initialized) {
         return;
     }
 
+#ifdef I2C_QUEUE_ENABLE
+    // A span of a previous render was not sent, redraw the whole display
+    if (oled_render_failed) {
+        oled_render_failed = false;
+        print("oled_render queued transfer failed\n");
+        oled_dirty = OLED_ALL_BLOCKS_MASK;
+    }
+#endif
+
     // Do we have work to do?
     oled_dirty &= OLED_ALL_BLOCKS_MASK;
     if (!oled_dirty || oled_scrolling) {
         return;
     }
 
-    // Find first dirty block
+    // Find first dirty block, and the dirty blocks that can be sent along with it
     uint8_t update_start = 0;
     while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
         ++update_start;
     }
+    uint8_t  update_count = calc_span(update_start);
+    uint16_t update_size  = OLED_BLOCK_SIZE * update_count;
 
-    // Set column & page position
-    static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+    // The column & page position commands and the render data go out in a single transfer
+    static uint8_t span_buffer[OLED_SPAN_HEADER_SIZE + OLED_SPAN_BLOCKS * OLED_BLOCK_SIZE];
+    uint8_t        display_start[] = {COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
+    uint8_t *      span_data       = &span_buffer[OLED_SPAN_HEADER_SIZE];
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
-    } else {
-        calc_bounds_90(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
-    }
+        calc_bounds(update_start, update_count, display_start);
 
-    // Send column & page position
-    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
-        print("oled_render offset command failed\n");
-        return;
-    }
-
-    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render data failed\n");
-            return;
-        }
+        // Send render data chunks as is
+        memcpy(span_data, &oled_buffer[OLED_BLOCK_SIZE * update_start], update_size);
     } else {
+        calc_bounds_90(update_start, update_count, display_start);
+
         // Rotate the render chunks
         const static uint8_t source_map[] = OLED_SOURCE_MAP;
         const static uint8_t target_map[] = OLED_TARGET_MAP;
 
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+        memset(span_data, 0, update_size);
+        for (uint8_t block = 0; block < update_count; ++block) {
+            for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+                rotate_90(&oled_buffer[OLED_BLOCK_SIZE * (update_start + block) + source_map[i]], &span_data[span_offset_90(target_map[i], block, update_count)]);
+            }
         }
+    }
+    for (uint8_t i = 0; i < sizeof(display_start); ++i) {
+        span_buffer[i * 2]     = I2C_CMD_CONTINUED;
+        span_buffer[i * 2 + 1] = display_start[i];
+    }
+    span_buffer[OLED_SPAN_HEADER_SIZE - 1] = I2C_DATA;
 
-        // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
-            print("oled_render90 data failed\n");
-            return;
-        }
+    if (I2C_RENDER_TRANSMIT(span_buffer, OLED_SPAN_HEADER_SIZE + update_size) != I2C_STATUS_SUCCESS) {
+        print("oled_render failed\n");
+        return;
     }
 
     // Turn on display if it is off
     oled_on();
 
-    // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+    // Clear dirty flags
+    for (uint8_t i = 0; i < update_count; ++i) {
+        oled_dirty &= ~((OLED_BLOCK_TYPE)1 << (update_start + i));
+    }
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
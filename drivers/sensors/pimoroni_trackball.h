@@ -52,7 +52,7 @@ typedef struct {
 void         pimoroni_trackball_device_init(void);
 void         pimoroni_trackball_set_rgbw(uint8_t red, uint8_t green, uint8_t blue, uint8_t white);
 int16_t      pimoroni_trackball_get_offsets(uint8_t negative_dir, uint8_t positive_dir, uint8_t scale);
-void         pimoroni_trackball_adapt_values(int8_t* mouse, int16_t* offset);
+void         pimoroni_trackball_adapt_values(mouse_xy_report_t* mouse, int16_t* offset);
 uint16_t     pimoroni_trackball_get_cpi(void);
 void         pimoroni_trackball_set_cpi(uint16_t cpi);
 i2c_status_t read_pimoroni_trackball(pimoroni_data_t* data);
@@ -22,6 +22,11 @@
 #include "debug.h"
 #include "print.h"
 #include "pmw3360_firmware.h"
+#ifdef PMW3360_MOTION_INTERRUPT
+#    include "timer.h"
+#    include <ch.h>
+#    include <hal.h>
+#endif
 
 // Registers
 // clang-format off
@@ -85,6 +90,33 @@
 
 bool _inBurst = false;
 
+#ifdef PMW3360_MOTION_INTERRUPT
+#    if !PAL_USE_WAIT
+#        error "PMW3360_MOTION_INTERRUPT requires PAL_USE_WAIT to be TRUE in your board's halconf.h"
+#    endif
+#    ifndef PMW3360_THREAD_STACK_SIZE
+#        define PMW3360_THREAD_STACK_SIZE 512
+#    endif
+
+_Static_assert((PMW3360_SAMPLE_BUFFER_SIZE & (PMW3360_SAMPLE_BUFFER_SIZE - 1)) == 0 && PMW3360_SAMPLE_BUFFER_SIZE <= 128, "PMW3360_SAMPLE_BUFFER_SIZE must be a power of two, no larger than 128");
+
+// Single producer (sampling thread), single consumer (main loop) ring buffer
+static pmw3360_sample_t samples[PMW3360_SAMPLE_BUFFER_SIZE];
+static uint8_t          sample_head = 0; // only written by the sampling thread, with release semantics
+static uint8_t          sample_tail = 0; // only written by the main loop, with release semantics
+
+// Keeps the sensor's multi-transfer sequences (burst mode entry and read, CPI access) whole. spi_start() already gives
+// the bus to one thread at a time, this keeps the main loop from leaving burst mode in the middle of a burst read.
+static MUTEX_DECL(pmw3360_mutex);
+#    define pmw3360_lock() chMtxLock(&pmw3360_mutex)
+#    define pmw3360_unlock() chMtxUnlock(&pmw3360_mutex)
+
+static void pmw3360_start_sampling(void);
+#else
+#    define pmw3360_lock()
+#    define pmw3360_unlock()
+#endif
+
 #ifdef CONSOLE_ENABLE
 void print_byte(uint8_t byte) {
     dprintf("%c%c%c%c%c%c%c%c|", (byte & 0x80 ? '1' : '0'), (byte & 0x40 ? '1' : '0'), (byte & 0x20 ? '1' : '0'), (byte & 0x10 ? '1' : '0'), (byte & 0x08 ? '1' : '0'), (byte & 0x04 ? '1' : '0'), (byte & 0x02 ? '1' : '0'), (byte & 0x01 ? '1' : '0'));
@@ -100,7 +132,9 @@ bool pmw3360_spi_start(void) {
 }
 
 spi_status_t pmw3360_write(uint8_t reg_addr, uint8_t data) {
-    pmw3360_spi_start();
+    if (!pmw3360_spi_start()) {
+        return SPI_STATUS_ERROR;
+    }
 
     if (reg_addr != REG_Motion_Burst) {
         _inBurst = false;
@@ -120,7 +154,9 @@ spi_status_t pmw3360_write(uint8_t reg_addr, uint8_t data) {
 }
 
 uint8_t pmw3360_read(uint8_t reg_addr) {
-    pmw3360_spi_start();
+    if (!pmw3360_spi_start()) {
+        return 0;
+    }
     // send adress of the register, with MSBit = 0 to indicate it's a read
     spi_write(reg_addr & 0x7f);
     // tSRAD (=160us)
@@ -191,6 +227,12 @@ bool pmw3360_init(void) {
 
     writePinLow(PMW3360_CS_PIN);
 
+#ifdef PMW3360_MOTION_INTERRUPT
+    if (init_success) {
+        pmw3360_start_sampling();
+    }
+#endif
+
     return init_success;
 }
 
@@ -204,7 +246,9 @@ void pmw3360_upload_firmware(void) {
 
     pmw3360_write(REG_SROM_Enable, 0x18);
 
-    pmw3360_spi_start();
+    if (!pmw3360_spi_start()) {
+        return;
+    }
     spi_write(REG_SROM_Load_Burst | 0x80);
     wait_us(15);
 
@@ -214,6 +258,8 @@ void pmw3360_upload_firmware(void) {
         wait_us(15);
 #endif
     }
+    // The burst ends when NCS goes high, the SROM_ID read below needs a transfer of its own
+    spi_stop();
     wait_us(200);
 
     pmw3360_read(REG_SROM_ID);
@@ -228,27 +274,32 @@ bool pmw3360_check_signature(void) {
 }
 
 uint16_t pmw3360_get_cpi(void) {
+    pmw3360_lock();
     uint8_t cpival = pmw3360_read(REG_Config1);
+    pmw3360_unlock();
     return (uint16_t)((cpival + 1) & 0xFF) * CPI_STEP;
 }
 
 void pmw3360_set_cpi(uint16_t cpi) {
     uint8_t cpival = constrain((cpi / CPI_STEP) - 1, 0, MAX_CPI);
+    pmw3360_lock();
     pmw3360_write(REG_Config1, cpival);
+    pmw3360_unlock();
 }
 
-report_pmw3360_t pmw3360_read_burst(void) {
+/* Reads the motion registers without printing anything, so that it can run from the sampling thread */
+static report_pmw3360_t pmw3360_read_motion(void) {
     report_pmw3360_t report = {0};
 
     if (!_inBurst) {
-#ifdef CONSOLE_ENABLE
-        dprintf("burst on");
-#endif
         pmw3360_write(REG_Motion_Burst, 0x00);
         _inBurst = true;
     }
 
-    pmw3360_spi_start();
+    if (!pmw3360_spi_start()) {
+        _inBurst = false;
+        return report;
+    }
     spi_write(REG_Motion_Burst);
     wait_us(35); // waits for tSRAD_MOTBR
 
@@ -266,6 +317,24 @@ report_pmw3360_t pmw3360_read_burst(void) {
 
     spi_stop();
 
+    report.isMotion    = (report.motion & 0x80) != 0;
+    report.isOnSurface = (report.motion & 0x08) == 0;
+    report.dx |= (report.mdx << 8);
+    report.dx = report.dx * -1;
+    report.dy |= (report.mdy << 8);
+    report.dy = report.dy * -1;
+
+    return report;
+}
+
+report_pmw3360_t pmw3360_read_burst(void) {
+#ifdef CONSOLE_ENABLE
+    if (!_inBurst) {
+        dprintf("burst on");
+    }
+#endif
+    report_pmw3360_t report = pmw3360_read_motion();
+
 #ifdef CONSOLE_ENABLE
     if (debug_mouse) {
         print_byte(report.motion);
@@ -277,12 +346,85 @@ report_pmw3360_t pmw3360_read_burst(void) {
     }
 #endif
 
-    report.isMotion    = (report.motion & 0x80) != 0;
-    report.isOnSurface = (report.motion & 0x08) == 0;
-    report.dx |= (report.mdx << 8);
-    report.dx = report.dx * -1;
-    report.dy |= (report.mdy << 8);
-    report.dy = report.dy * -1;
-
     return report;
 }
+
+#ifdef PMW3360_MOTION_INTERRUPT
+/**
+ * @brief This thread waits for the sensor to signal motion, and queues the burst reads for pointing_device_task.
+ */
+static THD_WORKING_AREA(waPMW3360Thread, PMW3360_THREAD_STACK_SIZE);
+static THD_FUNCTION(PMW3360Thread, arg) {
+    (void)arg;
+    chRegSetThreadName("pmw3360");
+
+    int16_t overflow_dx = 0;
+    int16_t overflow_dy = 0;
+
+    while (true) {
+        // MOTION is held low until the deltas have been read. Checking it and waiting under the lock keeps an edge
+        // from slipping in between, the timeout only covers a sensor that stopped signalling
+        chSysLock();
+        if (readPin(POINTING_DEVICE_MOTION_PIN)) {
+            palWaitLineTimeoutS(POINTING_DEVICE_MOTION_PIN, TIME_MS2I(100));
+            chSysUnlock();
+            continue;
+        }
+        chSysUnlock();
+
+        // The console is not thread safe, samples are not printed from here
+        pmw3360_lock();
+        report_pmw3360_t report = pmw3360_read_motion();
+        pmw3360_unlock();
+
+        if (!report.isMotion || !report.isOnSurface) {
+            continue;
+        }
+
+        pmw3360_sample_t sample = {.dx = report.dx + overflow_dx, .dy = report.dy + overflow_dy, .time = timer_read()};
+#    ifdef USB_MOUSE_COALESCE
+        sample.systime = chVTGetSystemTimeX();
+#    endif
+        uint8_t next = (sample_head + 1) % PMW3360_SAMPLE_BUFFER_SIZE;
+        if (next == __atomic_load_n(&sample_tail, __ATOMIC_ACQUIRE)) {
+            // Keep the motion for the next sample rather than dropping it
+            overflow_dx = sample.dx;
+            overflow_dy = sample.dy;
+            continue;
+        }
+        overflow_dx = overflow_dy = 0;
+
+        samples[sample_head] = sample;
+        __atomic_store_n(&sample_head, next, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Start sampling on the MOTION pin, called once the sensor has been initialised.
+ */
+static void pmw3360_start_sampling(void) {
+    static bool started = false;
+    if (started) {
+        return;
+    }
+    started = true;
+
+    setPinInputHigh(POINTING_DEVICE_MOTION_PIN);
+    palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_FALLING_EDGE);
+    chThdCreateStatic(waPMW3360Thread, sizeof(waPMW3360Thread), HIGHPRIO, PMW3360Thread, NULL);
+}
+
+/**
+ * @brief Take the oldest sample queued by the sampling thread.
+ *
+ * @return true if a sample was available.
+ */
+bool pmw3360_get_sample(pmw3360_sample_t *sample) {
+    if (sample_tail == __atomic_load_n(&sample_head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *sample = samples[sample_tail];
+    __atomic_store_n(&sample_tail, (sample_tail + 1) % PMW3360_SAMPLE_BUFFER_SIZE, __ATOMIC_RELEASE);
+    return true;
+}
+#endif
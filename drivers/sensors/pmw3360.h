@@ -19,6 +19,9 @@
 #pragma once
 
 #include <stdint.h>
+#if defined(PMW3360_MOTION_INTERRUPT) && defined(USB_MOUSE_COALESCE)
+#    include <ch.h>
+#endif
 
 #ifndef PMW3360_CPI
 #    define PMW3360_CPI 1600
@@ -56,6 +59,18 @@
 #    error "No chip select pin defined -- missing PMW3360_CS_PIN"
 #endif
 
+#ifdef PMW3360_MOTION_INTERRUPT
+#    ifndef POINTING_DEVICE_MOTION_PIN
+#        error "PMW3360_MOTION_INTERRUPT requires POINTING_DEVICE_MOTION_PIN"
+#    endif
+#    ifndef PROTOCOL_CHIBIOS
+#        error "PMW3360_MOTION_INTERRUPT is only supported on ChibiOS"
+#    endif
+#    ifndef PMW3360_SAMPLE_BUFFER_SIZE
+#        define PMW3360_SAMPLE_BUFFER_SIZE 16
+#    endif
+#endif
+
 typedef struct {
     int8_t  motion;
     bool    isMotion;    // True if a motion is detected.
@@ -66,6 +81,15 @@ typedef struct {
     int8_t  mdy;
 } report_pmw3360_t;
 
+typedef struct {
+    int16_t  dx;   // displacement accumulated since the previous sample
+    int16_t  dy;
+    uint16_t time; // timer_read() at the time of the burst read
+#if defined(PMW3360_MOTION_INTERRUPT) && defined(USB_MOUSE_COALESCE)
+    systime_t systime; // the same, in system ticks for the report latency histogram
+#endif
+} pmw3360_sample_t;
+
 bool     pmw3360_init(void);
 void     pmw3360_upload_firmware(void);
 bool     pmw3360_check_signature(void);
@@ -73,3 +97,6 @@ uint16_t pmw3360_get_cpi(void);
 void     pmw3360_set_cpi(uint16_t cpi);
 /* Reads and clears the current delta values on the sensor */
 report_pmw3360_t pmw3360_read_burst(void);
+#ifdef PMW3360_MOTION_INTERRUPT
+bool pmw3360_get_sample(pmw3360_sample_t *sample);
+#endif
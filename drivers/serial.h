@@ -27,3 +27,7 @@ void soft_serial_initiator_init(void);
 void soft_serial_target_init(void);
 
 bool soft_serial_transaction(int sstd_index);
+
+// non-blocking transactions, only provided by drivers that support them (e.g. SERIAL_USART_ASYNC)
+bool soft_serial_transaction_start(int sstd_index);
+bool soft_serial_transaction_wait(void);
@@ -94,3 +94,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef DEBOUNCE
 #    define DEBOUNCE 5
 #endif
+
+// drag-scroll, carret and custom mode run on the core pointing device modes, with the keyboard's own settings
+#ifdef POINTING_DEVICE_MODES_ENABLE
+#    ifndef CHARYBDIS_DRAGSCROLL_BUFFER_SIZE
+#        define CHARYBDIS_DRAGSCROLL_BUFFER_SIZE 6
+#    endif
+#    ifndef CHARYBDIS_CARRET_BUFFER
+#        define CHARYBDIS_CARRET_BUFFER 40
+#    endif
+#    ifndef POINTING_DEVICE_SCROLL_DIVISOR
+#        define POINTING_DEVICE_SCROLL_DIVISOR (CHARYBDIS_DRAGSCROLL_BUFFER_SIZE + 1)
+#    endif
+#    ifndef POINTING_DEVICE_CARET_DIVISOR
+#        define POINTING_DEVICE_CARET_DIVISOR (CHARYBDIS_CARRET_BUFFER / 4)
+#    endif
+// drag-scroll turns the wheels with the motion unless reversed, the core modes scroll against it
+#    if defined(CHARYBDIS_DRAGSCROLL_REVERSE_X) && !defined(POINTING_DEVICE_SCROLL_INVERT_X)
+#        define POINTING_DEVICE_SCROLL_INVERT_X
+#    endif
+#    if !defined(CHARYBDIS_DRAGSCROLL_REVERSE_Y) && !defined(POINTING_DEVICE_SCROLL_INVERT_Y)
+#        define POINTING_DEVICE_SCROLL_INVERT_Y
+#    endif
+#endif
@@ -24,6 +24,10 @@
 #    include "print.h"
 #endif  // CONSOLE_ENABLE
 
+#ifdef POINTING_DEVICE_MODES_ENABLE
+#    include "pointing_device_modes.h"
+#endif  // POINTING_DEVICE_MODES_ENABLE
+
 #ifdef POINTING_DEVICE_ENABLE
 #    ifndef CHARYBDIS_MINIMUM_DEFAULT_DPI
 #        define CHARYBDIS_MINIMUM_DEFAULT_DPI 400
@@ -137,6 +141,44 @@ static void maybe_update_pointing_device_cpi(charybdis_config_t* config) {
     }
 }
 
+#    ifdef POINTING_DEVICE_MODES_ENABLE
+/**
+ * \brief Hand drag-scroll, carret and custom mode over to the core pointing device modes.
+ *
+ * Integration mode and mode mode keep the keyboard's own handling: integration
+ * scales the tap and detent sizes at runtime, which the core modes do not, and
+ * mode mode picks a mode with the motion rather than translating it.
+ */
+static void maybe_update_pointing_device_mode(charybdis_config_t* config) {
+    if (config->is_integ_enabled || config->is_modemode_enabled) {
+        pointing_device_set_mode(POINTING_DEVICE_MODE_POINTER);
+    } else if (config->is_dragscroll_enabled) {
+        pointing_device_set_mode(POINTING_DEVICE_MODE_SCROLL);
+    } else if (config->is_carret_enabled) {
+        // Carret mode taps up for downwards motion unless reversed
+#        ifdef CHARYBDIS_CARRET_REVERSE_X
+        uint16_t right = KC_LEFT, left = KC_RIGHT;
+#        else
+        uint16_t right = KC_RIGHT, left = KC_LEFT;
+#        endif
+#        ifdef CHARYBDIS_CARRET_REVERSE_Y
+        uint16_t up = KC_UP, down = KC_DOWN;
+#        else
+        uint16_t up = KC_DOWN, down = KC_UP;
+#        endif
+        pointing_device_set_caret_keycodes(right, left, up, down);
+        pointing_device_set_mode(POINTING_DEVICE_MODE_CARET);
+    } else if (config->is_custom_enabled) {
+        pointing_device_set_caret_keycodes(CUSTOM_FN_RIGHT, CUSTOM_FN_LEFT, CUSTOM_FN_UP, CUSTOM_FN_DOWN);
+        pointing_device_set_mode(POINTING_DEVICE_MODE_CARET);
+    } else {
+        pointing_device_set_mode(POINTING_DEVICE_MODE_POINTER);
+    }
+}
+#    else
+#        define maybe_update_pointing_device_mode(config)
+#    endif  // POINTING_DEVICE_MODES_ENABLE
+
 /**
  * \brief Update the pointer's default DPI to the next or previous step.
  *
@@ -182,6 +224,7 @@ bool charybdis_get_pointer_sniping_enabled(void) { return g_charybdis_config.is_
 void charybdis_set_pointer_sniping_enabled(bool enable) {
     g_charybdis_config.is_sniping_enabled = enable;
     maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
 bool charybdis_get_pointer_dragscroll_enabled(void) { return g_charybdis_config.is_dragscroll_enabled; }
@@ -190,6 +233,7 @@ void charybdis_set_pointer_dragscroll_enabled(bool enable) {
 	charybdis_set_pointer_disable_nonstacking();
     g_charybdis_config.is_dragscroll_enabled = enable;
     maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
 bool charybdis_get_pointer_carret_enabled(void) { return g_charybdis_config.is_carret_enabled; }
@@ -198,6 +242,7 @@ void charybdis_set_pointer_carret_enabled(bool enable) {
 	charybdis_set_pointer_disable_nonstacking();
     g_charybdis_config.is_carret_enabled = enable;
     maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
 bool charybdis_get_pointer_custom_enabled(void) { return g_charybdis_config.is_custom_enabled; }
@@ -206,6 +251,7 @@ void charybdis_set_pointer_custom_enabled(bool enable) {
 	charybdis_set_pointer_disable_nonstacking();
     g_charybdis_config.is_custom_enabled = enable;
     maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
 bool charybdis_get_pointer_modemode_enabled(void) { return g_charybdis_config.is_modemode_enabled; }
@@ -213,6 +259,7 @@ bool charybdis_get_pointer_modemode_enabled(void) { return g_charybdis_config.is
 void charybdis_set_pointer_modemode_enabled(bool enable) {
     g_charybdis_config.is_modemode_enabled = enable;
     maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
 bool charybdis_get_pointer_integ_enabled(void) { return g_charybdis_config.is_integ_enabled; }
@@ -220,15 +267,20 @@ bool charybdis_get_pointer_integ_enabled(void) { return g_charybdis_config.is_in
 void charybdis_set_pointer_integ_enabled(bool enable) {
     g_charybdis_config.is_integ_enabled = enable;
     maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
 void charybdis_set_pointer_disable_nonstacking(void) {
     g_charybdis_config.is_dragscroll_enabled = false;
     g_charybdis_config.is_carret_enabled = false;
     g_charybdis_config.is_custom_enabled = false;
+    maybe_update_pointing_device_mode(&g_charybdis_config);
 }
 
-void pointing_device_init_kb(void) { maybe_update_pointing_device_cpi(&g_charybdis_config); }
+void pointing_device_init_kb(void) {
+    maybe_update_pointing_device_cpi(&g_charybdis_config);
+    maybe_update_pointing_device_mode(&g_charybdis_config);
+}
 
 #    ifndef CONSTRAIN_HID
 #        define CONSTRAIN_HID(value) ((value) < -127 ? -127 : ((value) > 127 ? 127 : (value)))
@@ -241,10 +293,10 @@ void tap_tb(uint8_t keycode0, uint8_t keycode1, uint8_t keycode2, uint8_t keycod
  *
  * If `CHARYBDIS_POINTER_ACCELERATION_ENABLE` is defined, add a simple and naive
  * acceleration effect to the provided value.  Return the value unchanged
- * otherwise.
+ * otherwise, or when the core pointer acceleration is enabled instead.
  */
 #    ifndef DISPLACEMENT_WITH_ACCELERATION
-#        ifdef CHARYBDIS_POINTER_ACCELERATION_ENABLE
+#        if defined(CHARYBDIS_POINTER_ACCELERATION_ENABLE) && !defined(POINTING_DEVICE_ACCEL_ENABLE)
 #            define DISPLACEMENT_WITH_ACCELERATION(d) (CONSTRAIN_HID(d > 0 ? d * d / CHARYBDIS_POINTER_ACCELERATION_FACTOR + d : -d * d / CHARYBDIS_POINTER_ACCELERATION_FACTOR + d))
 #        else  // !CHARYBDIS_POINTER_ACCELERATION_ENABLE
 #            define DISPLACEMENT_WITH_ACCELERATION(d) (d)
@@ -344,6 +396,12 @@ void tap_modes(int16_t *move_buffer_x, int16_t *move_buffer_y) {
  *   - Acceleration
  */
 static void pointing_device_task_charybdis(report_mouse_t* mouse_report) {
+#    ifdef POINTING_DEVICE_MODES_ENABLE
+    // The core modes turn the motion into wheel motion or taps, see maybe_update_pointing_device_mode()
+    if (pointing_device_get_mode() != POINTING_DEVICE_MODE_POINTER) {
+        return;
+    }
+#    endif  // POINTING_DEVICE_MODES_ENABLE
     static int16_t move_buffer_x = 0;
     static int16_t move_buffer_y = 0;
     static int16_t local_mouse_report_x;
@@ -69,6 +69,7 @@ subcommands = [
     'qmk.cli.new.keymap',
     'qmk.cli.pyformat',
     'qmk.cli.pytest',
+    'qmk.cli.scan_profile',
     'qmk.cli.via2json',
 ]
 
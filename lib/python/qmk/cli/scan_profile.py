@@ -0,0 +1,89 @@
+"""Read the scan loop profiler of a connected keyboard.
+
+The firmware must be built with `SCAN_PROFILER_ENABLE = yes` and `RAW_ENABLE = yes`.
+"""
+import struct
+
+from milc import cli
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+RAW_EPSIZE = 32
+
+SCAN_PROFILER_RAW_HID_ID = 0xF0
+GET_INFO = 0x01
+GET_STATS = 0x02
+RESET = 0x03
+UNHANDLED = 0xFF
+
+
+def _find_device(device):
+    """Returns the path of the first raw HID interface matching the optional `vid:pid` filter.
+    """
+    import hid
+
+    vid = pid = None
+    if device:
+        vid, pid = (int(part, 16) for part in device.split(':'))
+
+    for interface in hid.enumerate(vid or 0, pid or 0):
+        if interface['usage_page'] == RAW_USAGE_PAGE and interface['usage'] == RAW_USAGE_ID:
+            return interface['path']
+
+    return None
+
+
+def _request(device, command, *args):
+    """Sends a profiler request and returns the reply payload, after the command bytes.
+    """
+    packet = bytes([SCAN_PROFILER_RAW_HID_ID, command, *args]).ljust(RAW_EPSIZE, b'\0')
+    device.write(b'\0' + packet)  # report ID
+    reply = bytes(device.read(RAW_EPSIZE, 1000))
+
+    if len(reply) < 2 or reply[0] != SCAN_PROFILER_RAW_HID_ID or reply[1] != command:
+        raise ValueError('The keyboard did not answer the profiler request, is SCAN_PROFILER_ENABLE set?')
+
+    return reply[2:]
+
+
+@cli.argument('-d', '--device', help='USB VID:PID of the keyboard, in hex. Defaults to the first raw HID interface found.')
+@cli.argument('-r', '--reset', arg_only=True, action='store_true', help='Clear the statistics after reading them.')
+@cli.subcommand('Show how long each firmware task takes per scan loop.')
+def scan_profile(cli):
+    """Print min/avg/max/p99 durations of each profiled task.
+    """
+    try:
+        import hid
+    except ImportError:
+        cli.log.error('The hid module is required, install it with: python3 -m pip install hid')
+        return False
+
+    path = _find_device(cli.config.scan_profile.device)
+    if not path:
+        cli.log.error('No keyboard with a raw HID interface found.')
+        return False
+
+    device = hid.Device(path=path)
+    try:
+        version, count, clock_hz = struct.unpack_from('<BBI', _request(device, GET_INFO))
+        cli.log.info('Profiler version %d, clock {fg_cyan}%d Hz{fg_reset}, durations in microseconds', version, clock_hz)
+
+        cli.echo('%-10s %10s %10s %10s %10s %10s', 'task', 'calls', 'min', 'avg', 'max', 'p99')
+        for index in range(count):
+            payload = _request(device, GET_STATS, index)
+            calls, *ticks = struct.unpack_from('<IIIII', payload, 1)
+            name = payload[21:29].split(b'\0')[0].decode('ascii')
+            if not calls:
+                continue
+
+            cli.echo('%-10s %10d %10.1f %10.1f %10.1f %10.1f', name, calls, *(t * 1000000 / clock_hz for t in ticks))
+
+        if cli.args.reset:
+            _request(device, RESET)
+
+    except ValueError as e:
+        cli.log.error(e)
+        return False
+
+    finally:
+        device.close()
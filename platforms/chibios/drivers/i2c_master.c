@@ -88,6 +88,26 @@
 #    endif
 #endif
 
+#ifdef I2C_QUEUE_ENABLE
+// Serialises the direct transfers below with those of the queue worker thread
+static MUTEX_DECL(i2c_bus_mutex);
+static thread_t* i2c_queue_thread = NULL;
+
+/* Direct transfers from other threads first wait for the queued ones, so that they reach the bus in the order they were
+ * issued. Queue callbacks run on the worker thread and go straight to the bus. */
+static void i2c_bus_lock(void) {
+    if (i2c_queue_thread && chThdGetSelfX() != i2c_queue_thread) {
+        i2c_queue_flush();
+    }
+    chMtxLock(&i2c_bus_mutex);
+}
+#    define I2C_BUS_LOCK() i2c_bus_lock()
+#    define I2C_BUS_UNLOCK() chMtxUnlock(&i2c_bus_mutex)
+#else
+#    define I2C_BUS_LOCK()
+#    define I2C_BUS_UNLOCK()
+#endif
+
 static uint8_t i2c_address;
 
 static const I2CConfig i2cconfig = {
@@ -140,26 +160,33 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_start(uint8_t address) {
+    I2C_BUS_LOCK();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
+    I2C_BUS_UNLOCK();
     return I2C_STATUS_SUCCESS;
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_BUS_LOCK();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
+    I2C_BUS_UNLOCK();
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_BUS_LOCK();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
+    I2C_BUS_UNLOCK();
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_BUS_LOCK();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -170,10 +197,12 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
     complete_packet[0] = regaddr;
 
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 1, 0, 0, TIME_MS2I(timeout));
+    I2C_BUS_UNLOCK();
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_BUS_LOCK();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -185,24 +214,165 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
     complete_packet[1] = regaddr & 0xFF;
 
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), complete_packet, length + 2, 0, 0, TIME_MS2I(timeout));
+    I2C_BUS_UNLOCK();
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_BUS_LOCK();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
+    I2C_BUS_UNLOCK();
     return chibios_to_qmk(&status);
 }
 
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_BUS_LOCK();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
     msg_t   status             = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), register_packet, 2, data, length, TIME_MS2I(timeout));
+    I2C_BUS_UNLOCK();
     return chibios_to_qmk(&status);
 }
 
 void i2c_stop(void) {
+    I2C_BUS_LOCK();
     i2cStop(&I2C_DRIVER);
+    I2C_BUS_UNLOCK();
+}
+
+#ifdef I2C_QUEUE_ENABLE
+typedef struct {
+    uint8_t              address;
+    uint16_t             length;
+    uint16_t             timeout;
+    i2c_queue_callback_t callback;
+    void*                arg;
+    uint8_t              data[I2C_QUEUE_TRANSFER_SIZE];
+} i2c_queue_entry_t;
+
+/* A single producer, single consumer ring: claiming and committing an entry is not atomic, so transfers must only be
+ * queued from one thread, usually the main loop. Any thread may flush. */
+static i2c_queue_entry_t i2c_queue[I2C_QUEUE_SIZE];
+static uint8_t           i2c_queue_head     = 0; // only written by the queueing thread
+static uint8_t           i2c_queue_tail     = 0; // only written by the worker thread
+static uint8_t           i2c_queue_pending  = 0; // transfers queued and not done yet, in the kernel locked state
+static thread_t*         i2c_queue_producer = NULL;
+static SEMAPHORE_DECL(i2c_queue_used, 0);
+static SEMAPHORE_DECL(i2c_queue_free, I2C_QUEUE_SIZE);
+static THREADS_QUEUE_DECL(i2c_queue_idle); // threads waiting in i2c_queue_flush()
+
+/** \brief Sends the queued transfers in order, waiting for each one to complete
+ *
+ * Its priority is just above the main loop, so the next transfer starts as soon as the previous one completes.
+ */
+static THD_WORKING_AREA(waI2CQueueThread, I2C_QUEUE_STACK_SIZE);
+static THD_FUNCTION(I2CQueueThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_queue");
+
+    while (true) {
+        chSemWait(&i2c_queue_used);
+        i2c_queue_entry_t* entry = &i2c_queue[i2c_queue_tail];
+
+        I2C_BUS_LOCK();
+        i2cStart(&I2C_DRIVER, &i2cconfig);
+        msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (entry->address >> 1), entry->data, entry->length, 0, 0, TIME_MS2I(entry->timeout));
+        I2C_BUS_UNLOCK();
+
+        if (entry->callback) {
+            entry->callback(chibios_to_qmk(&status), entry->arg);
+        }
+
+        i2c_queue_tail = (i2c_queue_tail + 1) % I2C_QUEUE_SIZE;
+        chSemSignal(&i2c_queue_free);
+
+        chSysLock();
+        if (--i2c_queue_pending == 0) {
+            chThdDequeueAllI(&i2c_queue_idle, MSG_OK);
+            chSchRescheduleS();
+        }
+        chSysUnlock();
+    }
+}
+
+/* Returns the next free entry, waiting for the worker thread to send one if the queue is full */
+static i2c_queue_entry_t* i2c_queue_claim(uint8_t address, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* arg) {
+    if (!i2c_queue_thread) {
+        i2c_queue_producer = chThdGetSelfX();
+        i2c_queue_thread   = chThdCreateStatic(waI2CQueueThread, sizeof(waI2CQueueThread), NORMALPRIO + 1, I2CQueueThread, NULL);
+    }
+    chDbgAssert(chThdGetSelfX() == i2c_queue_producer, "transfers queued from more than one thread");
+    chSemWait(&i2c_queue_free);
+
+    i2c_queue_entry_t* entry = &i2c_queue[i2c_queue_head];
+    entry->address           = address;
+    entry->length            = length;
+    entry->timeout           = timeout;
+    entry->callback          = callback;
+    entry->arg               = arg;
+    return entry;
 }
+
+/* Hands the entry returned by i2c_queue_claim() over to the worker thread */
+static void i2c_queue_commit(void) {
+    i2c_queue_head = (i2c_queue_head + 1) % I2C_QUEUE_SIZE;
+    chSysLock();
+    i2c_queue_pending++;
+    chSysUnlock();
+    chSemSignal(&i2c_queue_used);
+}
+
+/** \brief Queues a transfer, returning without waiting for the bus
+ *
+ * Transfers larger than I2C_QUEUE_TRANSFER_SIZE are sent directly once the queue has drained.
+ */
+i2c_status_t i2c_queue_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* arg) {
+    if (length > I2C_QUEUE_TRANSFER_SIZE) {
+        i2c_status_t status = i2c_transmit(address, data, length, timeout);
+        if (callback) {
+            callback(status, arg);
+        }
+        return status;
+    }
+
+    i2c_queue_entry_t* entry = i2c_queue_claim(address, length, timeout, callback, arg);
+    memcpy(entry->data, data, length);
+    i2c_queue_commit();
+    return I2C_STATUS_SUCCESS;
+}
+
+/** \brief Queues a register write, returning without waiting for the bus
+ *
+ * Writes larger than I2C_QUEUE_TRANSFER_SIZE (register address included) are sent directly once the queue has drained.
+ */
+i2c_status_t i2c_queue_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* arg) {
+    if (length + 1 > I2C_QUEUE_TRANSFER_SIZE) {
+        i2c_status_t status = i2c_writeReg(devaddr, regaddr, data, length, timeout);
+        if (callback) {
+            callback(status, arg);
+        }
+        return status;
+    }
+
+    i2c_queue_entry_t* entry = i2c_queue_claim(devaddr, length + 1, timeout, callback, arg);
+    entry->data[0]           = regaddr;
+    memcpy(&entry->data[1], data, length);
+    i2c_queue_commit();
+    return I2C_STATUS_SUCCESS;
+}
+
+/** \brief Waits until every queued transfer has been sent and its callback called
+ *
+ * Any number of threads may wait at the same time. Must not be called from a queue callback.
+ */
+void i2c_queue_flush(void) {
+    chSysLock();
+    while (i2c_queue_pending) {
+        chThdEnqueueTimeoutS(&i2c_queue_idle, TIME_INFINITE);
+    }
+    chSysUnlock();
+}
+#endif
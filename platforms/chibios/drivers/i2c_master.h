@@ -41,3 +41,25 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 void         i2c_stop(void);
+
+/* Transfers queued for the I2C worker thread, see I2C_QUEUE_ENABLE.
+ * The data is copied, so the caller may reuse its buffer straight away.
+ * The callback, if any, is called from the worker thread once the transfer is done.
+ * Transfers must only be queued from one thread, the queue being single producer.
+ */
+#ifndef I2C_QUEUE_SIZE
+#    define I2C_QUEUE_SIZE 16
+#endif
+#ifndef I2C_QUEUE_TRANSFER_SIZE
+// Room for a 64 byte block of a 128x64 OLED along with its 13 bytes of addressing commands
+#    define I2C_QUEUE_TRANSFER_SIZE 80
+#endif
+#ifndef I2C_QUEUE_STACK_SIZE
+#    define I2C_QUEUE_STACK_SIZE 256
+#endif
+
+typedef void (*i2c_queue_callback_t)(i2c_status_t status, void* arg);
+
+i2c_status_t i2c_queue_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* arg);
+i2c_status_t i2c_queue_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* arg);
+void         i2c_queue_flush(void);
@@ -16,6 +16,10 @@
 
 #include "serial_usart.h"
 
+#if defined(SERIAL_USART_ASYNC) && !defined(SPLIT_TRANSACTION_BATCH)
+#    error "SERIAL_USART_ASYNC requires SPLIT_TRANSACTION_BATCH, every other transaction waits for its reply anyway"
+#endif
+
 #if defined(SERIAL_USART_CONFIG)
 static SerialConfig serial_config = SERIAL_USART_CONFIG;
 #else
@@ -231,6 +235,35 @@ static inline bool react_to_transactions(void) {
     return true;
 }
 
+#if defined(SERIAL_USART_ASYNC)
+static BSEMAPHORE_DECL(async_start, true);
+static BSEMAPHORE_DECL(async_done, true);
+static volatile uint8_t async_index  = 0;
+static volatile bool    async_busy   = false;
+static volatile bool    async_result = false;
+
+/**
+ * @brief This thread runs on the master and performs the transactions started
+ * by soft_serial_transaction_start, so the main loop doesn't have to wait for them.
+ */
+static THD_WORKING_AREA(waMasterThread, 1024);
+static THD_FUNCTION(MasterThread, arg) {
+    (void)arg;
+    chRegSetThreadName("usart_async");
+
+    while (true) {
+        chBSemWait(&async_start);
+
+        /* Clear the receive queue, to start with a clean slate.
+         * Parts of failed transactions or spurious bytes could still be in it. */
+        usart_clear();
+        async_result = initiate_transaction(async_index);
+
+        chBSemSignal(&async_done);
+    }
+}
+#endif
+
 /**
  * @brief Master specific initializations.
  */
@@ -242,8 +275,57 @@ void soft_serial_initiator_init(void) {
 #endif
 
     sdStart(serial_driver, &serial_config);
+
+#if defined(SERIAL_USART_ASYNC)
+    /* Start transport thread. */
+    chThdCreateStatic(waMasterThread, sizeof(waMasterThread), HIGHPRIO, MasterThread, NULL);
+#endif
+}
+
+#if defined(SERIAL_USART_ASYNC)
+/**
+ * @brief Start transaction from the master half to the slave half, without waiting for it to complete.
+ *
+ * Any previously started transaction is completed first, its result is discarded.
+ *
+ * @param index Transaction Table index of the transaction to start.
+ * @return bool Indicates the transaction was started.
+ */
+bool soft_serial_transaction_start(int index) {
+    soft_serial_transaction_wait();
+
+    async_index = (uint8_t)index;
+    async_busy  = true;
+    chBSemSignal(&async_start);
+    return true;
+}
+
+/**
+ * @brief Wait for the transaction started by soft_serial_transaction_start to complete.
+ *
+ * @return bool Indicates success of transaction. False if no transaction was started.
+ */
+bool soft_serial_transaction_wait(void) {
+    if (!async_busy) {
+        return false;
+    }
+
+    chBSemWait(&async_done);
+    async_busy = false;
+    return async_result;
 }
 
+/**
+ * @brief Start transaction from the master half to the slave half.
+ *
+ * @param index Transaction Table index of the transaction to start.
+ * @return bool Indicates success of transaction.
+ */
+bool soft_serial_transaction(int index) {
+    soft_serial_transaction_start(index);
+    return soft_serial_transaction_wait();
+}
+#else
 /**
  * @brief Start transaction from the master half to the slave half.
  *
@@ -256,6 +338,7 @@ bool soft_serial_transaction(int index) {
     usart_clear();
     return initiate_transaction((uint8_t)index);
 }
+#endif
 
 /**
  * @brief Initiate transaction to slave half.
@@ -20,6 +20,10 @@
 
 static pin_t currentSlavePin = NO_PIN;
 
+// Gives the bus to one thread at a time, from spi_start() to spi_stop()
+static MUTEX_DECL(spi_bus_mutex);
+static thread_t *spi_bus_owner = NULL;
+
 #if defined(K20x) || defined(KL2x)
 static SPIConfig spiConfig = {NULL, 0, 0, 0};
 #else
@@ -49,7 +53,7 @@ __attribute__((weak)) void spi_init(void) {
     }
 }
 
-bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+static bool spi_start_locked(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     if (currentSlavePin != NO_PIN || slavePin == NO_PIN) {
         return false;
     }
@@ -227,6 +231,22 @@ bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
     return true;
 }
 
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    // Already started by this thread, waiting for the bus would never end
+    if (slavePin == NO_PIN || spi_bus_owner == chThdGetSelfX()) {
+        return false;
+    }
+
+    chMtxLock(&spi_bus_mutex);
+    spi_bus_owner = chThdGetSelfX();
+    if (!spi_start_locked(slavePin, lsbFirst, mode, divisor)) {
+        spi_bus_owner = NULL;
+        chMtxUnlock(&spi_bus_mutex);
+        return false;
+    }
+    return true;
+}
+
 spi_status_t spi_write(uint8_t data) {
     uint8_t rxData;
     spiExchange(&SPI_DRIVER, 1, &data, &rxData);
@@ -252,9 +272,11 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
 }
 
 void spi_stop(void) {
-    if (currentSlavePin != NO_PIN) {
+    if (currentSlavePin != NO_PIN && spi_bus_owner == chThdGetSelfX()) {
         spiUnselect(&SPI_DRIVER);
         spiStop(&SPI_DRIVER);
         currentSlavePin = NO_PIN;
+        spi_bus_owner   = NULL;
+        chMtxUnlock(&spi_bus_mutex);
     }
 }
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "quantum.h"
 #include "ws2812.h"
 
@@ -56,6 +57,10 @@
 #    define WS2812_SPI_DIVISOR_CR1_BR_X (SPI_CR1_BR_1 | SPI_CR1_BR_0) // default
 #endif
 
+#if defined(WS2812_SPI_DOUBLE_BUFFER) && (defined(WS2812_SPI_USE_CIRCULAR_BUFFER) || defined(WS2812_SPI_SYNC))
+#    error "WS2812_SPI_DOUBLE_BUFFER cannot be combined with WS2812_SPI_USE_CIRCULAR_BUFFER or WS2812_SPI_SYNC"
+#endif
+
 // Use SPI circular buffer
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
 #    define WS2812_SPI_BUFFER_MODE 1 // circular buffer
@@ -79,8 +84,41 @@
 #define DATA_SIZE (BYTES_FOR_LED * RGBLED_NUM)
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
+#define TXBUF_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+/*
+ * Frames are encoded into txbuf while the DMA streams the other buffer, which
+ * holds the last frame handed to the SPI. A frame encoded while the bus is
+ * still busy is marked pending and sent from the transfer end callback.
+ */
+static uint8_t       txbufs[2][TXBUF_SIZE] = {0};
+static uint8_t*      txbuf                 = txbufs[0];
+static volatile bool txbuf_pending         = false;
+
+static inline uint8_t* last_txbuf(void) {
+    return txbuf == txbufs[0] ? txbufs[1] : txbufs[0];
+}
+
+/* Must be called from a locked state */
+static void start_send(SPIDriver* spip) {
+    spiStartSendI(spip, TXBUF_SIZE, txbuf);
+    txbuf         = last_txbuf();
+    txbuf_pending = false;
+}
+
+static void spi_end_cb(SPIDriver* spip) {
+    osalSysLockFromISR();
+    if (txbuf_pending) {
+        start_send(spip);
+    }
+    osalSysUnlockFromISR();
+}
+#    define WS2812_SPI_END_CB spi_end_cb
+#else
+static uint8_t txbuf[TXBUF_SIZE] = {0};
+#    define WS2812_SPI_END_CB NULL
+#endif
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
@@ -139,13 +177,13 @@ void ws2812_init(void) {
 #endif // WS2812_SPI_SCK_PIN
 
     // TODO: more dynamic baudrate
-    static const SPIConfig spicfg = {WS2812_SPI_BUFFER_MODE, NULL, PAL_PORT(RGB_DI_PIN), PAL_PAD(RGB_DI_PIN), WS2812_SPI_DIVISOR_CR1_BR_X};
+    static const SPIConfig spicfg = {WS2812_SPI_BUFFER_MODE, WS2812_SPI_END_CB, PAL_PORT(RGB_DI_PIN), PAL_PAD(RGB_DI_PIN), WS2812_SPI_DIVISOR_CR1_BR_X};
 
     spiAcquireBus(&WS2812_SPI);     /* Acquire ownership of the bus.    */
     spiStart(&WS2812_SPI, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+    spiStartSend(&WS2812_SPI, TXBUF_SIZE, txbuf);
 #endif
 }
 
@@ -156,17 +194,39 @@ void ws2812_setleds(LED_TYPE* ledarray, uint16_t leds) {
         s_init = true;
     }
 
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+    // A frame still waiting for the bus is superseded and updated in place,
+    // otherwise the LEDs left out of this update are carried over from the last frame
+    osalSysLock();
+    bool superseded = txbuf_pending;
+    txbuf_pending   = false;
+    osalSysUnlock();
+    if (!superseded && leds < RGBLED_NUM) {
+        size_t offset = PREAMBLE_SIZE + BYTES_FOR_LED * leds;
+        memcpy(&txbuf[offset], &last_txbuf()[offset], BYTES_FOR_LED * (RGBLED_NUM - leds));
+    }
+#endif
+
     for (uint8_t i = 0; i < leds; i++) {
         set_led_color_rgb(ledarray[i], i);
     }
 
     // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
     // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
+    // With WS2812_SPI_DOUBLE_BUFFER, a frame encoded while the previous one is being sent is queued instead.
+#if defined(WS2812_SPI_DOUBLE_BUFFER)
+    osalSysLock();
+    if (WS2812_SPI.state == SPI_READY) {
+        start_send(&WS2812_SPI);
+    } else {
+        txbuf_pending = true;
+    }
+    osalSysUnlock();
+#elif !defined(WS2812_SPI_USE_CIRCULAR_BUFFER)
 #    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+    spiSend(&WS2812_SPI, TXBUF_SIZE, txbuf);
 #    else
-    spiStartSend(&WS2812_SPI, sizeof(txbuf) / sizeof(txbuf[0]), txbuf);
+    spiStartSend(&WS2812_SPI, TXBUF_SIZE, txbuf);
 #    endif
 #endif
 }
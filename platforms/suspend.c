@@ -41,9 +41,14 @@ __attribute__((weak)) void suspend_wakeup_init_kb(void) {
  * FIXME: needs doc
  */
 bool suspend_wakeup_condition(void) {
+#ifndef MATRIX_SCAN_THREAD
     matrix_power_up();
     matrix_scan();
     matrix_power_down();
+#else
+    // the scan thread keeps scanning, pick up its last scan
+    matrix_sync();
+#endif
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         if (matrix_get_row(r)) return true;
     }
@@ -16,3 +16,9 @@
 #pragma once
 
 // here just to please the build
+
+#include <stdint.h>
+
+// simulated clock with microsecond resolution, see timer.c
+uint32_t timer_read_us(void);
+void     advance_time_us(uint32_t us);
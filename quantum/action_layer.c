@@ -3,6 +3,9 @@
 #include "action.h"
 #include "util.h"
 #include "action_layer.h"
+#if defined(LAYER_RESOLUTION_CACHE) && !defined(NO_ACTION_LAYER)
+#    include "matrix.h"
+#endif
 
 #ifdef DEBUG_ACTION
 #    include "debug.h"
@@ -14,6 +17,65 @@
  */
 layer_state_t default_layer_state = 0;
 
+#if defined(LAYER_RESOLUTION_CACHE) && !defined(NO_ACTION_LAYER)
+/** \brief resolved layers cache
+ *
+ * Topmost non-transparent layer of each key, valid for resolved_layers_state.
+ */
+static uint8_t       resolved_layers_cache[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t  resolved_layers_valid[MATRIX_ROWS];
+static layer_state_t resolved_layers_state = 0;
+
+/** \brief update resolved layers cache
+ *
+ * Invalidates only the keys whose resolved layer may differ under the new layer state:
+ * keys resolved to a layer that got turned off, or below a layer that got turned on.
+ */
+static void update_resolved_layers_cache(layer_state_t layers) {
+    if (layers == resolved_layers_state) {
+        return;
+    }
+
+    layer_state_t enabled         = layers & ~resolved_layers_state;
+    uint8_t       highest_enabled = get_highest_layer(enabled);
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t valid = resolved_layers_valid[row];
+        for (uint8_t col = 0; valid; col++, valid >>= 1) {
+            if (valid & 1) {
+                uint8_t layer = resolved_layers_cache[row][col];
+                if ((enabled && highest_enabled > layer) || !(layers & ((layer_state_t)1 << layer))) {
+                    resolved_layers_valid[row] &= ~(MATRIX_ROW_SHIFTER << col);
+                }
+            }
+        }
+    }
+    resolved_layers_state = layers;
+}
+
+/** \brief clear resolved layers cache
+ *
+ * Forces every key to be resolved again, e.g. after the keymap has been rewritten
+ */
+void clear_resolved_layers_cache(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        resolved_layers_valid[row] = 0;
+    }
+}
+
+/** \brief clear resolved layers cache for a key
+ *
+ * Forces the key to be resolved again, e.g. after one of its keycodes has changed
+ */
+void clear_resolved_layers_cache_key(keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        resolved_layers_valid[key.row] &= ~(MATRIX_ROW_SHIFTER << key.col);
+    }
+}
+#else
+#    define update_resolved_layers_cache(layers)
+#endif
+
 /** \brief Default Layer State Set At user Level
  *
  * Run user code on default layer state change
@@ -40,6 +102,7 @@ static void default_layer_state_set(layer_state_t state) {
     default_layer_debug();
     debug(" to ");
     default_layer_state = state;
+    update_resolved_layers_cache(layer_state | default_layer_state);
     default_layer_debug();
     debug("\n");
 #ifdef STRICT_LAYER_RELEASE
@@ -120,6 +183,7 @@ void layer_state_set(layer_state_t state) {
     layer_debug();
     dprint(" to ");
     layer_state = state;
+    update_resolved_layers_cache(layer_state | default_layer_state);
     layer_debug();
     dprintln();
 #    ifdef STRICT_LAYER_RELEASE
@@ -284,16 +348,15 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#ifndef NO_ACTION_LAYER
+/** \brief Resolve layer
  *
- * Gets the layer based on key info
+ * Searches the given layer state for the topmost non-transparent layer of the key
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
-#ifndef NO_ACTION_LAYER
+static uint8_t resolve_layer(keypos_t key, layer_state_t layers) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -305,6 +368,29 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+#    ifdef LAYER_RESOLUTION_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        /* catch layer state written directly instead of through layer_state_set() */
+        update_resolved_layers_cache(layers);
+
+        if (!(resolved_layers_valid[key.row] & (MATRIX_ROW_SHIFTER << key.col))) {
+            resolved_layers_cache[key.row][key.col] = resolve_layer(key, layers);
+            resolved_layers_valid[key.row] |= MATRIX_ROW_SHIFTER << key.col;
+        }
+        return resolved_layers_cache[key.row][key.col];
+    }
+#    endif
+    return resolve_layer(key, layers);
 #else
     return get_highest_layer(default_layer_state);
 #endif
@@ -22,6 +22,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "timer.h"
 #include "keycode_config.h"
 #include <string.h>
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 
 extern keymap_config_t keymap_config;
 
@@ -271,6 +274,9 @@ void send_keyboard_report(void) {
 #endif
 
 #ifdef PROTOCOL_VUSB
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_report_sent();
+#    endif
     host_keyboard_send(keyboard_report);
 #else
     static report_keyboard_t last_report;
@@ -278,6 +284,9 @@ void send_keyboard_report(void) {
     /* Only send the report if there are changes to propagate to the host. */
     if (memcmp(keyboard_report, &last_report, sizeof(report_keyboard_t)) != 0) {
         memcpy(&last_report, keyboard_report, sizeof(report_keyboard_t));
+#    ifdef LATENCY_TRACE_ENABLE
+        latency_trace_report_sent();
+#    endif
         host_keyboard_send(keyboard_report);
     }
 #endif
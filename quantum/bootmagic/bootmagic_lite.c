@@ -36,6 +36,11 @@ __attribute__((weak)) void bootmagic_lite(void) {
     wait_ms(30);
 #endif
     matrix_scan();
+#ifdef MATRIX_SCAN_THREAD
+    // The scan thread isn't running yet, hand this scan to the main thread directly
+    matrix_publish();
+    matrix_sync();
+#endif
 
     // If the configured key (commonly Esc) is held down on power up,
     // reset the EEPROM valid state and jump to bootloader.
@@ -108,6 +108,56 @@ RGB hsv_to_rgb_nocie(HSV hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
 
+/* Index of v, p, q and t in the value array below, for each RGB channel of a hue region.
+ * Region 7 is used for greys, where every channel is v.
+ */
+static const uint8_t hsv_region_channels[8][3] PROGMEM = {
+    {0, 3, 1}, {2, 0, 1}, {1, 0, 3}, {1, 2, 0}, {3, 1, 0}, {0, 1, 2}, {0, 3, 1}, {0, 0, 0},
+};
+
+/* Same result as hsv_to_rgb_impl(), with the region switch replaced by a table lookup */
+static inline RGB hsv_to_rgb_lookup(HSV hsv, bool use_cie) {
+    RGB      rgb;
+    uint8_t  values[4];
+    uint8_t  region, remainder;
+    uint16_t s = hsv.s;
+    uint16_t v = hsv.v;
+
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
+    }
+#endif
+
+    region    = hsv.h * 6 / 255;
+    remainder = (hsv.h * 2 - region * 85) * 3;
+
+    values[0] = v;
+    values[1] = (v * (255 - s)) >> 8;
+    values[2] = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    values[3] = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    const uint8_t *channels = hsv_region_channels[region | (-(uint8_t)(s == 0) & 7)];
+    rgb.r                   = values[pgm_read_byte(&channels[0])];
+    rgb.g                   = values[pgm_read_byte(&channels[1])];
+    rgb.b                   = values[pgm_read_byte(&channels[2])];
+    return rgb;
+}
+
+/** \brief Converts count HSV colours to RGB in one pass
+ *
+ * Gives the same result as calling hsv_to_rgb() on each colour, but avoids the per colour call and branches.
+ */
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+#ifdef USE_CIE1931_CURVE
+        rgb[i] = hsv_to_rgb_lookup(hsv[i], true);
+#else
+        rgb[i] = hsv_to_rgb_lookup(hsv[i], false);
+#endif
+    }
+}
+
 #ifdef RGBW
 #    ifndef MIN
 #        define MIN(a, b) ((a) < (b) ? (a) : (b))
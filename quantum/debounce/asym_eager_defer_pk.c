@@ -52,6 +52,7 @@ typedef struct {
 
 #if DEBOUNCE > 0
 static debounce_counter_t *debounce_counters;
+static matrix_row_t       *active_keys; // keys with a running counter, per row
 static fast_timer_t        last_time;
 static bool                counters_need_update;
 static bool                matrix_need_update;
@@ -63,18 +64,21 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
 
 // we use num_rows rather than MATRIX_ROWS to support split keyboards
 void debounce_init(uint8_t num_rows) {
-    debounce_counters = malloc(num_rows * MATRIX_COLS * sizeof(debounce_counter_t));
+    debounce_counters = (debounce_counter_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_counter_t));
     int i             = 0;
     for (uint8_t r = 0; r < num_rows; r++) {
         for (uint8_t c = 0; c < MATRIX_COLS; c++) {
             debounce_counters[i++].time = DEBOUNCE_ELAPSED;
         }
     }
+    active_keys = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
 }
 
 void debounce_free(void) {
     free(debounce_counters);
     debounce_counters = NULL;
+    free(active_keys);
+    active_keys = NULL;
 }
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -105,62 +109,67 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 }
 
 static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
-
     counters_need_update = false;
     matrix_need_update   = false;
 
     for (uint8_t row = 0; row < num_rows; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-
-            if (debounce_pointer->time != DEBOUNCE_ELAPSED) {
-                if (debounce_pointer->time <= elapsed_time) {
-                    debounce_pointer->time = DEBOUNCE_ELAPSED;
-
-                    if (debounce_pointer->pressed) {
-                        // key-down: eager
-                        matrix_need_update = true;
-                    } else {
-                        // key-up: defer
-                        cooked[row] = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
-                    }
+        matrix_row_t active = active_keys[row];
+        for (matrix_row_t keys = active; keys; keys &= keys - 1) {
+            uint8_t             col              = matrix_row_ctz(keys);
+            matrix_row_t        col_mask         = (ROW_SHIFTER << col);
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+
+            if (debounce_pointer->time <= elapsed_time) {
+                debounce_pointer->time = DEBOUNCE_ELAPSED;
+                active &= ~col_mask;
+
+                if (debounce_pointer->pressed) {
+                    // key-down: eager
+                    matrix_need_update = true;
                 } else {
-                    debounce_pointer->time -= elapsed_time;
-                    counters_need_update = true;
+                    // key-up: defer
+                    cooked[row] = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
                 }
+            } else {
+                debounce_pointer->time -= elapsed_time;
+                counters_need_update = true;
             }
-            debounce_pointer++;
         }
+        active_keys[row] = active;
     }
 }
 
 static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
-
     for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta = raw[row] ^ cooked[row];
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-
-            if (delta & col_mask) {
-                if (debounce_pointer->time == DEBOUNCE_ELAPSED) {
-                    debounce_pointer->pressed = (raw[row] & col_mask);
-                    debounce_pointer->time    = DEBOUNCE;
-                    counters_need_update      = true;
-
-                    if (debounce_pointer->pressed) {
-                        // key-down: eager
-                        cooked[row] ^= col_mask;
-                    }
-                }
-            } else if (debounce_pointer->time != DEBOUNCE_ELAPSED) {
-                if (!debounce_pointer->pressed) {
-                    // key-up: defer
-                    debounce_pointer->time = DEBOUNCE_ELAPSED;
-                }
+        matrix_row_t delta   = raw[row] ^ cooked[row];
+        matrix_row_t started = delta & ~active_keys[row];
+        matrix_row_t settled = active_keys[row] & ~delta;
+
+        for (; started; started &= started - 1) {
+            uint8_t             col              = matrix_row_ctz(started);
+            matrix_row_t        col_mask         = (ROW_SHIFTER << col);
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+
+            debounce_pointer->pressed = (raw[row] & col_mask);
+            debounce_pointer->time    = DEBOUNCE;
+            counters_need_update      = true;
+            active_keys[row] |= col_mask;
+
+            if (debounce_pointer->pressed) {
+                // key-down: eager
+                cooked[row] ^= col_mask;
+            }
+        }
+
+        for (; settled; settled &= settled - 1) {
+            uint8_t             col              = matrix_row_ctz(settled);
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+
+            if (!debounce_pointer->pressed) {
+                // key-up: defer
+                debounce_pointer->time = DEBOUNCE_ELAPSED;
+                active_keys[row] &= ~(ROW_SHIFTER << col);
             }
-            debounce_pointer++;
         }
     }
 }
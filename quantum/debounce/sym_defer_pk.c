@@ -46,6 +46,7 @@ typedef uint8_t debounce_counter_t;
 
 #if DEBOUNCE > 0
 static debounce_counter_t *debounce_counters;
+static matrix_row_t       *active_keys; // keys with a running counter, per row
 static fast_timer_t        last_time;
 static bool                counters_need_update;
 
@@ -63,11 +64,14 @@ void debounce_init(uint8_t num_rows) {
             debounce_counters[i++] = DEBOUNCE_ELAPSED;
         }
     }
+    active_keys = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
 }
 
 void debounce_free(void) {
     free(debounce_counters);
     debounce_counters = NULL;
+    free(active_keys);
+    active_keys = NULL;
 }
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -98,39 +102,41 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 }
 
 static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
-    counters_need_update                 = false;
-    debounce_counter_t *debounce_pointer = debounce_counters;
+    counters_need_update = false;
     for (uint8_t row = 0; row < num_rows; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-                if (*debounce_pointer <= elapsed_time) {
-                    *debounce_pointer = DEBOUNCE_ELAPSED;
-                    cooked[row]       = (cooked[row] & ~(ROW_SHIFTER << col)) | (raw[row] & (ROW_SHIFTER << col));
-                } else {
-                    *debounce_pointer -= elapsed_time;
-                    counters_need_update = true;
-                }
+        matrix_row_t active = active_keys[row];
+        for (matrix_row_t keys = active; keys; keys &= keys - 1) {
+            uint8_t             col              = matrix_row_ctz(keys);
+            matrix_row_t        col_mask         = ROW_SHIFTER << col;
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+            if (*debounce_pointer <= elapsed_time) {
+                *debounce_pointer = DEBOUNCE_ELAPSED;
+                cooked[row]       = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
+                active &= ~col_mask;
+            } else {
+                *debounce_pointer -= elapsed_time;
+                counters_need_update = true;
             }
-            debounce_pointer++;
         }
+        active_keys[row] = active;
     }
 }
 
 static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
     for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta = raw[row] ^ cooked[row];
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            if (delta & (ROW_SHIFTER << col)) {
-                if (*debounce_pointer == DEBOUNCE_ELAPSED) {
-                    *debounce_pointer    = DEBOUNCE;
-                    counters_need_update = true;
-                }
-            } else {
-                *debounce_pointer = DEBOUNCE_ELAPSED;
-            }
-            debounce_pointer++;
+        matrix_row_t delta   = raw[row] ^ cooked[row];
+        matrix_row_t stopped = active_keys[row] & ~delta;
+        matrix_row_t started = delta & ~active_keys[row];
+        for (; stopped; stopped &= stopped - 1) {
+            debounce_counters[row * MATRIX_COLS + matrix_row_ctz(stopped)] = DEBOUNCE_ELAPSED;
+        }
+        if (started) {
+            counters_need_update = true;
+        }
+        for (; started; started &= started - 1) {
+            debounce_counters[row * MATRIX_COLS + matrix_row_ctz(started)] = DEBOUNCE;
         }
+        active_keys[row] = delta;
     }
 }
 
@@ -0,0 +1,184 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Symmetric per-key algorithm using vertical counters, behaving exactly like sym_defer_pk.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+
+Instead of one 8-bit counter per key, the counters of a row are stored bit-sliced: plane n of a row holds bit n of
+the counter of every key in that row. Counting down then takes one subtraction per plane for the whole row, whatever
+its width, and a row without any key being debounced is skipped with a single comparison.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include <stdlib.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    if CH_CFG_USE_MEMCORE == FALSE
+#        error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with this debounce algorithm.
+#    endif
+#endif
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+// Number of bit planes needed to hold DEBOUNCE
+#if DEBOUNCE < 2
+#    define COUNTER_BITS 1
+#elif DEBOUNCE < 4
+#    define COUNTER_BITS 2
+#elif DEBOUNCE < 8
+#    define COUNTER_BITS 3
+#elif DEBOUNCE < 16
+#    define COUNTER_BITS 4
+#elif DEBOUNCE < 32
+#    define COUNTER_BITS 5
+#elif DEBOUNCE < 64
+#    define COUNTER_BITS 6
+#elif DEBOUNCE < 128
+#    define COUNTER_BITS 7
+#else
+#    define COUNTER_BITS 8
+#endif
+
+#if DEBOUNCE > 0
+static matrix_row_t *counter_planes; // num_rows * COUNTER_BITS planes
+static matrix_row_t *active_keys;    // keys with a non-zero counter, per row
+static fast_timer_t  last_time;
+static bool          counters_need_update;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    counter_planes = (matrix_row_t *)calloc(num_rows * COUNTER_BITS, sizeof(matrix_row_t));
+    active_keys    = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
+}
+
+void debounce_free(void) {
+    free(counter_planes);
+    counter_planes = NULL;
+    free(active_keys);
+    active_keys = NULL;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t active = active_keys[row];
+        if (!active) {
+            continue;
+        }
+
+        // Subtract elapsed_time from every counter of the row at once, rippling the borrow through the planes
+        matrix_row_t *planes  = &counter_planes[row * COUNTER_BITS];
+        matrix_row_t  borrow  = 0;
+        matrix_row_t  nonzero = 0;
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            matrix_row_t plane = planes[bit];
+            if (elapsed_time & (1 << bit)) {
+                planes[bit] = ~(plane ^ borrow) & active;
+                borrow      = ~plane | borrow;
+            } else {
+                planes[bit] = (plane ^ borrow) & active;
+                borrow      = ~plane & borrow;
+            }
+            nonzero |= planes[bit];
+        }
+
+        // A counter expires when it reaches zero or would go below it
+        matrix_row_t expired = active & (borrow | ~nonzero);
+#    if COUNTER_BITS < 8
+        if (elapsed_time >> COUNTER_BITS) {
+            expired = active;
+        }
+#    endif
+        if (expired) {
+            cooked[row] = (cooked[row] & ~expired) | (raw[row] & expired);
+            active &= ~expired;
+            for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+                planes[bit] &= active;
+            }
+        }
+
+        active_keys[row] = active;
+        if (active) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t  delta  = raw[row] ^ cooked[row];
+        matrix_row_t  start  = delta & ~active_keys[row];
+        matrix_row_t *planes = &counter_planes[row * COUNTER_BITS];
+
+        // Keys that went back to their debounced state stop counting, changed keys that were idle start at DEBOUNCE
+        for (uint8_t bit = 0; bit < COUNTER_BITS; bit++) {
+            planes[bit] &= delta;
+            if (DEBOUNCE & (1 << bit)) {
+                planes[bit] |= start;
+            }
+        }
+
+        active_keys[row] = delta;
+        if (start) {
+            counters_need_update = true;
+        }
+    }
+}
+
+#else
+#    include "none.c"
+#endif
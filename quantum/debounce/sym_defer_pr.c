@@ -31,12 +31,15 @@ static uint16_t last_time;
 static uint8_t* countdowns;
 // [row]
 static matrix_row_t* last_raw;
+// whether any row is still counting down
+static bool counters_need_update;
 
 void debounce_init(uint8_t num_rows) {
     countdowns = (uint8_t*)calloc(num_rows, sizeof(uint8_t));
     last_raw   = (matrix_row_t*)calloc(num_rows, sizeof(matrix_row_t));
 
-    last_time = timer_read();
+    last_time            = timer_read();
+    counters_need_update = false;
 }
 
 void debounce_free(void) {
@@ -52,16 +55,24 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     last_time          = now;
     uint8_t elapsed    = (elapsed16 > 255) ? 255 : elapsed16;
 
+    // rows can only start or finish counting down while the raw matrix changes or a countdown is running
+    if (!changed && !counters_need_update) {
+        return;
+    }
+    counters_need_update = false;
+
     uint8_t* countdown = countdowns;
 
     for (uint8_t row = 0; row < num_rows; ++row, ++countdown) {
         matrix_row_t raw_row = raw[row];
 
         if (raw_row != last_raw[row]) {
-            *countdown    = DEBOUNCE;
-            last_raw[row] = raw_row;
+            *countdown           = DEBOUNCE;
+            last_raw[row]        = raw_row;
+            counters_need_update = true;
         } else if (*countdown > elapsed) {
             *countdown -= elapsed;
+            counters_need_update = true;
         } else if (*countdown) {
             cooked[row] = raw_row;
             *countdown  = 0;
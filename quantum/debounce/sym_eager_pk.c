@@ -46,6 +46,7 @@ typedef uint8_t debounce_counter_t;
 
 #if DEBOUNCE > 0
 static debounce_counter_t *debounce_counters;
+static matrix_row_t       *active_keys; // keys with a running counter, per row
 static fast_timer_t        last_time;
 static bool                counters_need_update;
 static bool                matrix_need_update;
@@ -64,11 +65,14 @@ void debounce_init(uint8_t num_rows) {
             debounce_counters[i++] = DEBOUNCE_ELAPSED;
         }
     }
+    active_keys = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
 }
 
 void debounce_free(void) {
     free(debounce_counters);
     debounce_counters = NULL;
+    free(active_keys);
+    active_keys = NULL;
 }
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -100,43 +104,40 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 
 // If the current time is > debounce counter, set the counter to enable input.
 static void update_debounce_counters(uint8_t num_rows, uint8_t elapsed_time) {
-    counters_need_update                 = false;
-    matrix_need_update                   = false;
-    debounce_counter_t *debounce_pointer = debounce_counters;
+    counters_need_update = false;
+    matrix_need_update   = false;
     for (uint8_t row = 0; row < num_rows; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-                if (*debounce_pointer <= elapsed_time) {
-                    *debounce_pointer  = DEBOUNCE_ELAPSED;
-                    matrix_need_update = true;
-                } else {
-                    *debounce_pointer -= elapsed_time;
-                    counters_need_update = true;
-                }
+        matrix_row_t active = active_keys[row];
+        for (matrix_row_t keys = active; keys; keys &= keys - 1) {
+            uint8_t             col              = matrix_row_ctz(keys);
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+            if (*debounce_pointer <= elapsed_time) {
+                *debounce_pointer  = DEBOUNCE_ELAPSED;
+                matrix_need_update = true;
+                active &= ~(ROW_SHIFTER << col);
+            } else {
+                *debounce_pointer -= elapsed_time;
+                counters_need_update = true;
             }
-            debounce_pointer++;
         }
+        active_keys[row] = active;
     }
 }
 
 // upload from raw_matrix to final matrix;
 static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
     for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta        = raw[row] ^ cooked[row];
-        matrix_row_t existing_row = cooked[row];
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-            if (delta & col_mask) {
-                if (*debounce_pointer == DEBOUNCE_ELAPSED) {
-                    *debounce_pointer    = DEBOUNCE;
-                    counters_need_update = true;
-                    existing_row ^= col_mask; // flip the bit.
-                }
-            }
-            debounce_pointer++;
+        matrix_row_t delta   = raw[row] ^ cooked[row];
+        matrix_row_t started = delta & ~active_keys[row];
+        if (!started) {
+            continue;
+        }
+        cooked[row] ^= started; // flip the bits.
+        active_keys[row] |= started;
+        counters_need_update = true;
+        for (; started; started &= started - 1) {
+            debounce_counters[row * MATRIX_COLS + matrix_row_ctz(started)] = DEBOUNCE;
         }
-        cooked[row] = existing_row;
     }
 }
 
@@ -0,0 +1,199 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Host-side microbenchmark of the debounce algorithms.
+
+Every algorithm is built into this one binary by including its source in a namespace of its own, then fed the same
+simulated matrix scans. The time taken per debounce() call is printed for each workload; it only gives an idea of
+the relative cost of the algorithms, as the host is nothing like a keyboard MCU. The bit-sliced sym_defer_pk_vc is
+also checked to produce exactly the same output as sym_defer_pk.
+*/
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "quantum.h"
+#include "timer.h"
+#include "debounce.h"
+#include <stdlib.h>
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+namespace sym_defer_g {
+#include "../sym_defer_g.c"
+}
+namespace sym_defer_pr {
+#include "../sym_defer_pr.c"
+}
+namespace sym_defer_pk {
+#include "../sym_defer_pk.c"
+}
+namespace sym_defer_pk_vc {
+#include "../sym_defer_pk_vc.c"
+}
+namespace sym_eager_pr {
+#include "../sym_eager_pr.c"
+}
+namespace sym_eager_pk {
+#include "../sym_eager_pk.c"
+}
+namespace asym_eager_defer_pk {
+#include "../asym_eager_defer_pk.c"
+}
+
+#define SCANS 20000
+
+struct Algorithm {
+    const char *name;
+    void (*init)(uint8_t num_rows);
+    void (*run)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+    void (*free)(void);
+};
+
+#define ALGORITHM(name) \
+    { #name, name::debounce_init, name::debounce, name::debounce_free }
+
+static const Algorithm algorithms[] = {
+    ALGORITHM(sym_defer_g),  ALGORITHM(sym_defer_pr), ALGORITHM(sym_defer_pk),        ALGORITHM(sym_defer_pk_vc),
+    ALGORITHM(sym_eager_pr), ALGORITHM(sym_eager_pk), ALGORITHM(asym_eager_defer_pk),
+};
+
+typedef std::vector<matrix_row_t> Scans; // SCANS * MATRIX_ROWS raw matrix rows
+
+static matrix_row_t col_bit(int col) {
+    return (matrix_row_t)1 << col;
+}
+
+/* No key ever changes state */
+static Scans idle_workload() {
+    return Scans(SCANS * MATRIX_ROWS, 0);
+}
+
+/* One key pressed at a time, every 40ms for 20ms, with 3ms of contact bounce on each edge */
+static Scans typing_workload() {
+    std::mt19937 rng(1);
+    Scans        scans(SCANS * MATRIX_ROWS, 0);
+
+    for (int start = 0; start + 40 <= SCANS; start += 40) {
+        int row = rng() % MATRIX_ROWS;
+        int col = rng() % MATRIX_COLS;
+        for (int t = 0; t < 20; t++) {
+            bool pressed = t < 3 ? (rng() & 1) : true;
+            if (pressed) {
+                scans[(start + t) * MATRIX_ROWS + row] |= col_bit(col);
+            }
+        }
+        for (int t = 20; t < 23; t++) {
+            if (rng() & 1) {
+                scans[(start + t) * MATRIX_ROWS + row] |= col_bit(col);
+            }
+        }
+    }
+    return scans;
+}
+
+/* A noisy matrix, where each key flips with a 5% chance on every scan */
+static Scans chatter_workload() {
+    std::mt19937 rng(2);
+    Scans        scans(SCANS * MATRIX_ROWS, 0);
+    matrix_row_t state[MATRIX_ROWS] = {0};
+
+    for (int scan = 0; scan < SCANS; scan++) {
+        for (int row = 0; row < MATRIX_ROWS; row++) {
+            for (int col = 0; col < MATRIX_COLS; col++) {
+                if (rng() % 20 == 0) {
+                    state[row] ^= col_bit(col);
+                }
+            }
+            scans[scan * MATRIX_ROWS + row] = state[row];
+        }
+    }
+    return scans;
+}
+
+/* Runs an algorithm over every scan at a 1ms scan rate, returning the nanoseconds taken per debounce() call */
+static double run(const Algorithm &algorithm, const Scans &scans, Scans *output) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+
+    algorithm.init(MATRIX_ROWS);
+    set_time(7777);
+
+    std::chrono::steady_clock::duration elapsed{0};
+    for (int scan = 0; scan < SCANS; scan++) {
+        const matrix_row_t *next    = &scans[scan * MATRIX_ROWS];
+        bool                changed = memcmp(raw, next, sizeof(raw)) != 0;
+        memcpy(raw, next, sizeof(raw));
+
+        auto start = std::chrono::steady_clock::now();
+        algorithm.run(raw, cooked, MATRIX_ROWS, changed);
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        if (output) {
+            output->insert(output->end(), std::begin(cooked), std::end(cooked));
+        }
+        advance_time(1);
+    }
+
+    algorithm.free();
+    return std::chrono::duration<double, std::nano>(elapsed).count() / SCANS;
+}
+
+static void benchmark(const char *workload, const Scans &scans) {
+    printf("%s, %dx%d matrix, DEBOUNCE %d\n", workload, MATRIX_ROWS, MATRIX_COLS, DEBOUNCE);
+    for (auto &algorithm : algorithms) {
+        printf("  %-20s %8.1f ns/scan\n", algorithm.name, run(algorithm, scans, nullptr));
+    }
+}
+
+static void expect_same_output(const Algorithm &reference, const Algorithm &algorithm, const Scans &scans) {
+    Scans expected, actual;
+    run(reference, scans, &expected);
+    run(algorithm, scans, &actual);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(expected[i], actual[i]) << algorithm.name << " differs from " << reference.name << " at scan " << i / MATRIX_ROWS << " row " << i % MATRIX_ROWS;
+    }
+}
+
+TEST(DebounceBenchmark, Idle) {
+    benchmark("idle", idle_workload());
+}
+
+TEST(DebounceBenchmark, Typing) {
+    benchmark("typing", typing_workload());
+}
+
+TEST(DebounceBenchmark, Chatter) {
+    benchmark("chatter", chatter_workload());
+}
+
+TEST(DebounceBenchmark, VerticalCountersMatchPerKeyCounters) {
+    const Algorithm reference = ALGORITHM(sym_defer_pk);
+    const Algorithm vertical  = ALGORITHM(sym_defer_pk_vc);
+
+    expect_same_output(reference, vertical, typing_workload());
+    expect_same_output(reference, vertical, chatter_workload());
+}
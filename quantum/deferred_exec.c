@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <stddef.h>
+#include <string.h>
 #include <timer.h>
 #include <deferred_exec.h>
 
@@ -9,62 +10,149 @@
 #    define MAX_DEFERRED_EXECUTORS 8
 #endif
 
+#if MAX_DEFERRED_EXECUTORS > 255
+#    error "MAX_DEFERRED_EXECUTORS must not exceed 255, the number of heap positions"
+#endif
+
 //------------------------------------
 // Helpers
 //
+// Each table is kept as a binary min-heap of its slots, ordered by trigger time, so that the task only has to look at
+// the root to know whether anything is due. Entries never move: table[pos].heap_slot holds the slot at heap position
+// pos, and table[slot].heap_pos the heap position of that slot. Both are stored XORed with their own index so that a
+// zero-initialised table already is a valid heap, unused entries sorting after all used ones.
+//
+// Tokens encode the slot they were allocated in, as (token - 1) % table_count, so that looking one up is O(1). They are
+// taken from a single counter shared by all tables, which only moves forward, so a token is handed out again only once
+// the whole token space went by.
+//
 
-static deferred_token current_token = 0;
+static deferred_token current_token = INVALID_DEFERRED_TOKEN;
 
-static inline bool token_can_be_used(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
+// Slots that already ran during the current task pass but are still due, as their executor is falling behind. They sort
+// after everything else in use, so that they cannot hold back the other due executors, and are put back in place once
+// the pass is over. Only one pass is tracked at a time.
+static deferred_executor_t *parked_table = NULL;
+static uint8_t              parked[(UINT8_MAX + 8) / 8];
+
+static inline bool is_parked(const deferred_executor_t *table, uint8_t slot) {
+    return table == parked_table && (parked[slot / 8] & (1 << (slot % 8)));
+}
+
+static inline uint8_t heap_slot(deferred_executor_t *table, uint8_t pos) {
+    return table[pos].heap_slot ^ pos;
+}
+
+static inline uint8_t heap_pos(deferred_executor_t *table, uint8_t slot) {
+    return table[slot].heap_pos ^ slot;
+}
+
+static inline void heap_place(deferred_executor_t *table, uint8_t pos, uint8_t slot) {
+    table[pos].heap_slot = slot ^ pos;
+    table[slot].heap_pos = pos ^ slot;
+}
+
+static inline bool triggers_before(const deferred_executor_t *table, uint8_t a_slot, uint8_t b_slot) {
+    const deferred_executor_t *a = &table[a_slot];
+    const deferred_executor_t *b = &table[b_slot];
+    if (a->token == INVALID_DEFERRED_TOKEN) {
         return false;
     }
-    for (int i = 0; i < table_count; ++i) {
-        if (table[i].token == token) {
-            return false;
+    if (b->token == INVALID_DEFERRED_TOKEN) {
+        return true;
+    }
+    bool a_parked = is_parked(table, a_slot);
+    if (a_parked != is_parked(table, b_slot)) {
+        return !a_parked;
+    }
+    return ((int32_t)TIMER_DIFF_32(a->trigger_time, b->trigger_time)) < 0;
+}
+
+static void heap_sift_up(deferred_executor_t *table, uint8_t pos) {
+    uint8_t slot = heap_slot(table, pos);
+    while (pos > 0) {
+        uint8_t parent      = (pos - 1) / 2;
+        uint8_t parent_slot = heap_slot(table, parent);
+        if (!triggers_before(table, slot, parent_slot)) {
+            break;
         }
+        heap_place(table, pos, parent_slot);
+        pos = parent;
     }
-    return true;
+    heap_place(table, pos, slot);
 }
 
-static inline deferred_token allocate_token(deferred_executor_t *table, size_t table_count) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(table, table_count, current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static void heap_sift_down(deferred_executor_t *table, size_t table_count, uint8_t pos) {
+    uint8_t slot = heap_slot(table, pos);
+    while (2 * (size_t)pos + 1 < table_count) {
+        uint8_t child      = 2 * pos + 1;
+        uint8_t child_slot = heap_slot(table, child);
+        if (child + 1 < table_count) {
+            uint8_t right_slot = heap_slot(table, child + 1);
+            if (triggers_before(table, right_slot, child_slot)) {
+                child      = child + 1;
+                child_slot = right_slot;
+            }
+        }
+        if (!triggers_before(table, child_slot, slot)) {
+            break;
         }
+        heap_place(table, pos, child_slot);
+        pos = child;
     }
+    heap_place(table, pos, slot);
+}
+
+// Restores the heap order after the trigger time or state of a slot changed
+static void heap_update(deferred_executor_t *table, size_t table_count, uint8_t slot) {
+    heap_sift_up(table, heap_pos(table, slot));
+    heap_sift_down(table, table_count, heap_pos(table, slot));
+}
+
+static inline deferred_token allocate_token(size_t table_count, uint8_t slot) {
+    // Skip ahead to the next token mapping to this slot
+    do {
+        ++current_token;
+    } while (current_token == INVALID_DEFERRED_TOKEN || (current_token - 1) % table_count != slot);
     return current_token;
 }
 
+static inline deferred_executor_t *find_executor(deferred_executor_t *table, size_t table_count, deferred_token token) {
+    if (!table || table_count == 0 || table_count > UINT8_MAX || token == INVALID_DEFERRED_TOKEN) {
+        return NULL;
+    }
+    deferred_executor_t *entry = &table[(token - 1) % table_count];
+    return entry->token == token ? entry : NULL;
+}
+
+static inline void release_executor(deferred_executor_t *entry) {
+    entry->token        = INVALID_DEFERRED_TOKEN;
+    entry->trigger_time = 0;
+    entry->callback     = NULL;
+    entry->cb_arg       = NULL;
+}
+
 //------------------------------------
 // Advanced API: used when a custom-allocated table is used, primarily for core code.
 //
 
 deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_count, uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || !callback) {
+    if (!table || table_count == 0 || table_count > UINT8_MAX || delay_ms == 0 || !callback) {
         return INVALID_DEFERRED_TOKEN;
     }
 
     // Find an unused slot and claim it
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
+    for (uint8_t slot = 0; slot < table_count; ++slot) {
+        deferred_executor_t *entry = &table[slot];
         if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token(table, table_count);
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
-
             // Set up the executor table entry
-            entry->token        = current_token;
+            entry->token        = allocate_token(table_count, slot);
             entry->trigger_time = timer_read32() + delay_ms;
             entry->callback     = callback;
             entry->cb_arg       = cb_arg;
-            return current_token;
+            heap_update(table, table_count, slot);
+            return entry->token;
         }
     }
 
@@ -73,78 +161,105 @@ deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_coun
 }
 
 bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token, uint32_t delay_ms) {
-    // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
+    // Ignore queueing if it's a zero-time delay
+    if (delay_ms == 0) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = find_executor(table, table_count, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    entry->trigger_time = timer_read32() + delay_ms;
+    heap_update(table, table_count, entry - table);
+    return true;
 }
 
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    // Ignore request if the table/token are not valid
-    if (!table || table_count == 0 || token == INVALID_DEFERRED_TOKEN) {
+    // Find the entry corresponding to the token
+    deferred_executor_t *entry = find_executor(table, table_count, token);
+    if (!entry) {
         return false;
     }
 
-    // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    // Found it, cancel and clear the table entry
+    release_executor(entry);
+    heap_update(table, table_count, entry - table);
+    return true;
+}
+
+bool deferred_exec_advanced_next_trigger(deferred_executor_t *table, size_t table_count, uint32_t *trigger_time) {
+    if (!table || table_count == 0 || table_count > UINT8_MAX) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // The root of the heap is the executor due first, if any is in use
+    deferred_executor_t *entry = &table[heap_slot(table, 0)];
+    if (entry->token == INVALID_DEFERRED_TOKEN) {
+        return false;
+    }
+    *trigger_time = entry->trigger_time;
+    return true;
 }
 
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time) {
     uint32_t now = timer_read32();
 
-    // Throttle only once per millisecond
-    if (((int32_t)TIMER_DIFF_32(now, (*last_execution_time))) > 0) {
+    // Throttle only once per millisecond. Passes do not nest, a task invoked from a callback is left to its next call.
+    if (table_count <= UINT8_MAX && !parked_table && ((int32_t)TIMER_DIFF_32(now, (*last_execution_time))) > 0) {
         *last_execution_time = now;
+        parked_table         = table;
+        bool any_parked      = false;
+
+        // Run the due executors in trigger order, at most one callback per table entry on each pass
+        for (size_t i = 0; i < table_count; ++i) {
+            uint8_t              slot  = heap_slot(table, 0);
+            deferred_executor_t *entry = &table[slot];
+
+            // Stop at the first executor that isn't due or already ran, everything after it in the heap is as well
+            if (entry->token == INVALID_DEFERRED_TOKEN || is_parked(table, slot) || ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) > 0) {
+                break;
+            }
+
+            // Invoke the callback and work work out if we should be requeued
+            deferred_token token    = entry->token;
+            uint32_t       delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
 
-        // Run through each of the executors
-        for (int i = 0; i < table_count; ++i) {
-            deferred_executor_t *entry = &table[i];
-
-            // Check if we're supposed to execute this entry
-            if (entry->token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
-
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
+            // The callback may have cancelled its own token, in which case the slot is no longer ours
+            if (entry->token != token) {
+                continue;
+            }
+
+            // Update the trigger time if we have to repeat, otherwise clear it out
+            if (delay_ms > 0) {
+                // Intentionally add just the delay to the existing trigger time -- this ensures the next
+                // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+                // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+                // considerable length of time, then this ensures best-effort timing between invocations.
+                entry->trigger_time += delay_ms;
+
+                // Still due, the executor is falling behind. Set it aside until the next pass rather than running it
+                // again and again here, while the other due executors still get their turn.
+                if (((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
+                    parked[slot / 8] |= 1 << (slot % 8);
+                    any_parked = true;
                 }
+            } else {
+                // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+                release_executor(entry);
+            }
+            heap_update(table, table_count, slot);
+        }
+
+        // Put the executors that fell behind back in trigger order. All of them move at once, so the heap is rebuilt
+        parked_table = NULL;
+        if (any_parked) {
+            memset(parked, 0, sizeof(parked));
+            for (uint8_t pos = table_count / 2; pos-- > 0;) {
+                heap_sift_down(table, table_count, pos);
             }
         }
     }
@@ -166,6 +281,9 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
 bool cancel_deferred_exec(deferred_token token) {
     return cancel_deferred_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, token);
 }
+bool deferred_exec_next_trigger(uint32_t *trigger_time) {
+    return deferred_exec_advanced_next_trigger(basic_executors, MAX_DEFERRED_EXECUTORS, trigger_time);
+}
 void deferred_exec_task(void) {
     deferred_exec_advanced_task(basic_executors, MAX_DEFERRED_EXECUTORS, &last_deferred_exec_check);
 }
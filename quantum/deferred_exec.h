@@ -14,7 +14,7 @@
 /**
  * @typedef A token that can be used to cancel or extend an existing deferred execution.
  */
-typedef uint8_t deferred_token;
+typedef uint16_t deferred_token;
 
 /**
  * @def The constant used to denote an invalid deferred execution token.
@@ -60,6 +60,14 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
  */
 bool cancel_deferred_exec(deferred_token token);
 
+/**
+ * Retrieves the time at which the next deferred execution is due, for example to know how long the keyboard may sleep.
+ *
+ * @param trigger_time[out] the trigger time of the next deferred execution -- equivalent time-space as timer_read32()
+ * @return true if a deferred execution is pending, otherwise false and trigger_time is left untouched
+ */
+bool deferred_exec_next_trigger(uint32_t *trigger_time);
+
 /**
  * Forward declaration for the main loop in order to execute any deferred executors. Should not be invoked by keyboard/user code.
  */
@@ -72,10 +80,13 @@ void deferred_exec_task(void);
 /**
  * @struct Structure for containing self-hosted deferred executor tables.
  * @brief Core-side code can use this to create their own tables without impacting on the use of users' ability to add deferred execution.
- *        Code outside deferred_exec.c should not worry about internals of this struct, and should just allocate the required number in an array.
+ *        Code outside deferred_exec.c should not worry about internals of this struct, and should just allocate the required number in a
+ *        zero-initialised array of at most 255 entries.
  */
 typedef struct deferred_executor_t {
     deferred_token         token;
+    uint8_t                heap_slot; // internal ordering of the table by trigger time, see deferred_exec.c
+    uint8_t                heap_pos;
     uint32_t               trigger_time;
     deferred_exec_callback callback;
     void *                 cb_arg;
@@ -110,6 +121,16 @@ bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_coun
  */
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token);
 
+/**
+ * Retrieves the time at which the next deferred execution of a custom table is due.
+ *
+ * @param table[in] the custom table used for storage
+ * @param table_count[in] the number of available items in the table
+ * @param trigger_time[out] the trigger time of the next deferred execution -- equivalent time-space as timer_read32()
+ * @return true if a deferred execution is pending, otherwise false and trigger_time is left untouched
+ */
+bool deferred_exec_advanced_next_trigger(deferred_executor_t *table, size_t table_count, uint32_t *trigger_time);
+
 /**
  * Forward declaration for the main loop in order to execute any custom table deferred executors. Should not be invoked by keyboard/user code.
  * Needed for any custom-allocated deferred execution tables. Any core tasks should add appropriate invocation to quantum/main.c.
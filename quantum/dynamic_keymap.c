@@ -79,6 +79,130 @@
 #    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
 #endif
 
+#define DYNAMIC_KEYMAP_EEPROM_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+#    ifndef DEFERRED_EXEC_ENABLE
+#        error DYNAMIC_KEYMAP_RAM_CACHE requires DEFERRED_EXEC_ENABLE = yes
+#    endif
+#    include "deferred_exec.h"
+
+// Time without further writes before dirty data is written back to EEPROM
+#    ifndef DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_DELAY
+#        define DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_DELAY 500
+#    endif
+// Number of dirty blocks written back per main loop iteration
+#    ifndef DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_BLOCKS
+#        define DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_BLOCKS 2
+#    endif
+
+#    define DYNAMIC_KEYMAP_RAM_CACHE_SIZE (DYNAMIC_KEYMAP_EEPROM_SIZE + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE)
+#    define DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_SIZE 16
+#    define DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_COUNT ((DYNAMIC_KEYMAP_RAM_CACHE_SIZE + DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_SIZE - 1) / DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_SIZE)
+
+// Keymaps followed by the macro buffer, mirroring their EEPROM contents
+static uint8_t dynamic_keymap_cache[DYNAMIC_KEYMAP_RAM_CACHE_SIZE];
+// One bit per block of the cache that has not been written back yet
+static uint8_t dynamic_keymap_cache_dirty[(DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_COUNT + 7) / 8];
+static bool    dynamic_keymap_cache_loaded = false;
+
+static deferred_executor_t dynamic_keymap_executors[1]     = {0};
+static uint32_t            dynamic_keymap_last_flush_check = 0;
+static deferred_token      dynamic_keymap_flush_token      = INVALID_DEFERRED_TOKEN;
+
+static void *dynamic_keymap_cache_index_to_eeprom_address(uint16_t index) {
+    if (index < DYNAMIC_KEYMAP_EEPROM_SIZE) {
+        return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + index;
+    }
+    return ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + (index - DYNAMIC_KEYMAP_EEPROM_SIZE);
+}
+
+static uint8_t *dynamic_keymap_cache_byte(void *address) {
+    if (!dynamic_keymap_cache_loaded) {
+        eeprom_read_block(dynamic_keymap_cache, (void *)DYNAMIC_KEYMAP_EEPROM_ADDR, DYNAMIC_KEYMAP_EEPROM_SIZE);
+        eeprom_read_block(dynamic_keymap_cache + DYNAMIC_KEYMAP_EEPROM_SIZE, (void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR, DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+        dynamic_keymap_cache_loaded = true;
+    }
+
+    if (address >= (void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR && address < ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
+        return &dynamic_keymap_cache[DYNAMIC_KEYMAP_EEPROM_SIZE + (address - (void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR)];
+    }
+    if (address >= (void *)DYNAMIC_KEYMAP_EEPROM_ADDR && address < ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + DYNAMIC_KEYMAP_EEPROM_SIZE) {
+        return &dynamic_keymap_cache[address - (void *)DYNAMIC_KEYMAP_EEPROM_ADDR];
+    }
+    // Not something the cache mirrors
+    return NULL;
+}
+
+// Writes back up to DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_BLOCKS dirty blocks, returns true if any are left
+static bool dynamic_keymap_flush_blocks(uint16_t max_blocks) {
+    for (uint16_t block = 0; block < DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_COUNT; block++) {
+        if (!(dynamic_keymap_cache_dirty[block / 8] & (1 << (block % 8)))) {
+            continue;
+        }
+        if (max_blocks-- == 0) {
+            return true;
+        }
+
+        uint16_t start = block * DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_SIZE;
+        uint16_t end   = start + DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_SIZE;
+        if (end > DYNAMIC_KEYMAP_RAM_CACHE_SIZE) {
+            end = DYNAMIC_KEYMAP_RAM_CACHE_SIZE;
+        }
+        for (uint16_t i = start; i < end; i++) {
+            eeprom_update_byte(dynamic_keymap_cache_index_to_eeprom_address(i), dynamic_keymap_cache[i]);
+        }
+        dynamic_keymap_cache_dirty[block / 8] &= ~(1 << (block % 8));
+    }
+    return false;
+}
+
+static uint32_t dynamic_keymap_flush_callback(uint32_t trigger_time, void *cb_arg) {
+    if (dynamic_keymap_flush_blocks(DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_BLOCKS)) {
+        // Yield to the rest of the main loop, then carry on
+        return 1;
+    }
+    dynamic_keymap_flush_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+static uint8_t dynamic_keymap_read_byte(void *address) {
+    uint8_t *cached = dynamic_keymap_cache_byte(address);
+    return cached ? *cached : 0;
+}
+
+static void dynamic_keymap_update_byte(void *address, uint8_t value) {
+    uint8_t *cached = dynamic_keymap_cache_byte(address);
+    if (!cached || *cached == value) {
+        return;
+    }
+    *cached = value;
+
+    uint16_t block = (cached - dynamic_keymap_cache) / DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_SIZE;
+    dynamic_keymap_cache_dirty[block / 8] |= 1 << (block % 8);
+
+    // Coalesce bursts of writes, only writing back once the host has gone quiet
+    if (!extend_deferred_exec_advanced(dynamic_keymap_executors, 1, dynamic_keymap_flush_token, DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_DELAY)) {
+        dynamic_keymap_flush_token = defer_exec_advanced(dynamic_keymap_executors, 1, DYNAMIC_KEYMAP_RAM_CACHE_FLUSH_DELAY, dynamic_keymap_flush_callback, NULL);
+    }
+}
+
+void dynamic_keymap_flush(void) {
+    dynamic_keymap_flush_blocks(DYNAMIC_KEYMAP_RAM_CACHE_BLOCK_COUNT);
+    cancel_deferred_exec_advanced(dynamic_keymap_executors, 1, dynamic_keymap_flush_token);
+    dynamic_keymap_flush_token = INVALID_DEFERRED_TOKEN;
+    // Reload on next access, the EEPROM may be changed behind our back from now on
+    dynamic_keymap_cache_loaded = false;
+}
+
+void dynamic_keymap_task(void) {
+    deferred_exec_advanced_task(dynamic_keymap_executors, 1, &dynamic_keymap_last_flush_check);
+}
+#else
+#    define dynamic_keymap_read_byte(address) eeprom_read_byte(address)
+#    define dynamic_keymap_update_byte(address, value) eeprom_update_byte(address, value)
+#endif
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -89,18 +213,24 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
 }
 
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
+
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = eeprom_read_byte(address) << 8;
-    keycode |= eeprom_read_byte(address + 1);
+    uint16_t keycode = dynamic_keymap_read_byte(address) << 8;
+    keycode |= dynamic_keymap_read_byte(address + 1);
     return keycode;
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
+
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address, (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    dynamic_keymap_update_byte(address, (uint8_t)(keycode >> 8));
+    dynamic_keymap_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    keypos_t key = {.row = row, .col = column};
+    clear_resolved_layers_cache_key(key);
 }
 
 void dynamic_keymap_reset(void) {
@@ -117,12 +247,11 @@ void dynamic_keymap_reset(void) {
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *target                     = data;
+    void *   source = ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset;
+    uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            *target = eeprom_read_byte(source);
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
+            *target = dynamic_keymap_read_byte(source);
         } else {
             *target = 0x00;
         }
@@ -132,16 +261,16 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *source                     = data;
+    void *   target = ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset;
+    uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            eeprom_update_byte(target, *source);
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
+            dynamic_keymap_update_byte(target, *source);
         }
         source++;
         target++;
     }
+    clear_resolved_layers_cache();
 }
 
 // This overrides the one in quantum/keymap_common.c
@@ -162,11 +291,11 @@ uint16_t dynamic_keymap_macro_get_buffer_size(void) {
 }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   source = ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset;
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            *target = eeprom_read_byte(source);
+            *target = dynamic_keymap_read_byte(source);
         } else {
             *target = 0x00;
         }
@@ -176,11 +305,11 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   target = ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset;
     uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            eeprom_update_byte(target, *source);
+            dynamic_keymap_update_byte(target, *source);
         }
         source++;
         target++;
@@ -191,7 +320,7 @@ void dynamic_keymap_macro_reset(void) {
     void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
     void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
     while (p != end) {
-        eeprom_update_byte(p, 0);
+        dynamic_keymap_update_byte(p, 0);
         ++p;
     }
 }
@@ -206,7 +335,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // of buffer writing, possibly an aborted buffer
     // write. So do nothing.
     void *p = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1);
-    if (eeprom_read_byte(p) != 0) {
+    if (dynamic_keymap_read_byte(p) != 0) {
         return;
     }
 
@@ -221,7 +350,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
         if (p == end) {
             return;
         }
-        if (eeprom_read_byte(p) == 0) {
+        if (dynamic_keymap_read_byte(p) == 0) {
             --id;
         }
         ++p;
@@ -233,7 +362,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // We already checked there was a null at the end of
     // the buffer, so this cannot go past the end
     while (1) {
-        data[0] = eeprom_read_byte(p++);
+        data[0] = dynamic_keymap_read_byte(p++);
         data[1] = 0;
         // Stop at the null terminator of this macro string
         if (data[0] == 0) {
@@ -244,7 +373,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
         if (data[0] == SS_TAP_CODE || data[0] == SS_DOWN_CODE || data[0] == SS_UP_CODE) {
             data[1] = data[0];
             data[0] = SS_QMK_PREFIX;
-            data[2] = eeprom_read_byte(p++);
+            data[2] = dynamic_keymap_read_byte(p++);
             if (data[2] == 0) {
                 break;
             }
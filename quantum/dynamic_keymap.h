@@ -58,3 +58,10 @@ void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t
 void     dynamic_keymap_macro_reset(void);
 
 void dynamic_keymap_macro_send(uint8_t id);
+
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+// Writes any pending changes held in the RAM cache back to EEPROM immediately
+void dynamic_keymap_flush(void);
+// Writes back pending changes once writes have settled, called from the main loop
+void dynamic_keymap_task(void);
+#endif
@@ -0,0 +1,120 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+#include "keycode.h"
+}
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define FLUSH_DELAY 500
+
+class DynamicKeymapRamCache : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        // Start from an empty EEPROM and a cache that reloads it
+        for (uint16_t i = 0; i < TOTAL_EEPROM_BYTE_COUNT; i++) {
+            eeprom_write_byte((uint8_t *)(uintptr_t)i, 0);
+        }
+        dynamic_keymap_flush();
+    }
+
+    uint16_t eeprom_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        return eeprom_read_byte(address) << 8 | eeprom_read_byte(address + 1);
+    }
+
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advance_time(1);
+            dynamic_keymap_task();
+        }
+    }
+};
+
+TEST_F(DynamicKeymapRamCache, ReadsThroughToEeprom) {
+    uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(1, 1, 2);
+    eeprom_write_byte(address, KC_ENTER >> 8);
+    eeprom_write_byte(address + 1, KC_ENTER & 0xFF);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 1, 2), KC_ENTER);
+
+    // Once loaded the cache is what is read
+    eeprom_write_byte(address + 1, KC_ESCAPE & 0xFF);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 1, 2), KC_ENTER);
+}
+
+TEST_F(DynamicKeymapRamCache, WritesBackAfterTheFlushDelay) {
+    dynamic_keymap_set_keycode(0, 1, 0, KC_SPACE);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 0), KC_SPACE);
+    EXPECT_EQ(eeprom_keycode(0, 1, 0), KC_NO);
+
+    run_for(FLUSH_DELAY - 1);
+    EXPECT_EQ(eeprom_keycode(0, 1, 0), KC_NO);
+    run_for(2);
+    EXPECT_EQ(eeprom_keycode(0, 1, 0), KC_SPACE);
+}
+
+TEST_F(DynamicKeymapRamCache, FurtherWritesPushTheFlushBack) {
+    dynamic_keymap_set_keycode(0, 0, 0, KC_A);
+    run_for(FLUSH_DELAY - 100);
+    dynamic_keymap_set_keycode(1, 0, 1, KC_B);
+    run_for(FLUSH_DELAY - 100);
+    EXPECT_EQ(eeprom_keycode(0, 0, 0), KC_NO);
+    EXPECT_EQ(eeprom_keycode(1, 0, 1), KC_NO);
+
+    run_for(101);
+    EXPECT_EQ(eeprom_keycode(0, 0, 0), KC_A);
+    EXPECT_EQ(eeprom_keycode(1, 0, 1), KC_B);
+}
+
+TEST_F(DynamicKeymapRamCache, FlushWritesBackAtOnce) {
+    uint8_t macros[] = {'h', 'i', 0};
+    dynamic_keymap_set_keycode(1, 0, 0, KC_TAB);
+    dynamic_keymap_macro_set_buffer(0, sizeof(macros), macros);
+
+    dynamic_keymap_flush();
+    EXPECT_EQ(eeprom_keycode(1, 0, 0), KC_TAB);
+    uint8_t read[sizeof(macros)];
+    dynamic_keymap_macro_get_buffer(0, sizeof(read), read);
+    EXPECT_EQ(memcmp(read, macros, sizeof(macros)), 0);
+
+    // Nothing left for the task to write
+    eeprom_write_byte((uint8_t *)dynamic_keymap_key_to_eeprom_address(1, 0, 0) + 1, 0);
+    run_for(FLUSH_DELAY + 1);
+    EXPECT_EQ(eeprom_keycode(1, 0, 0), KC_TAB & 0xFF00);
+}
+
+TEST_F(DynamicKeymapRamCache, IgnoresKeysOutsideTheKeymap) {
+    dynamic_keymap_set_keycode(DYNAMIC_KEYMAP_LAYER_COUNT, 0, 0, KC_A);
+    dynamic_keymap_set_keycode(0, MATRIX_ROWS, 0, KC_A);
+    dynamic_keymap_set_keycode(0, 0, MATRIX_COLS, KC_A);
+    EXPECT_EQ(dynamic_keymap_get_keycode(DYNAMIC_KEYMAP_LAYER_COUNT, 0, 0), KC_NO);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, MATRIX_ROWS, 0), KC_NO);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, MATRIX_COLS), KC_NO);
+
+    dynamic_keymap_flush();
+    for (uint16_t i = 0; i < TOTAL_EEPROM_BYTE_COUNT; i++) {
+        EXPECT_EQ(eeprom_read_byte((uint8_t *)(uintptr_t)i), 0) << "at " << i;
+    }
+}
@@ -0,0 +1,19 @@
+dynamic_keymap_ram_cache_DEFS := \
+	-DNO_DEBUG \
+	-DMATRIX_ROWS=2 \
+	-DMATRIX_COLS=3 \
+	-DDYNAMIC_KEYMAP_ENABLE \
+	-DDYNAMIC_KEYMAP_LAYER_COUNT=2 \
+	-DDYNAMIC_KEYMAP_EEPROM_ADDR=64 \
+	-DEEPROM_CUSTOM \
+	-DEEPROM_SIZE=256 \
+	-DDYNAMIC_KEYMAP_RAM_CACHE \
+	-DDEFERRED_EXEC_ENABLE
+
+dynamic_keymap_ram_cache_SRC := \
+	$(QUANTUM_PATH)/dynamic_keymap/tests/keymap_mock.c \
+	$(QUANTUM_PATH)/dynamic_keymap/tests/dynamic_keymap_ram_cache_tests.cpp \
+	$(QUANTUM_PATH)/dynamic_keymap.c \
+	$(QUANTUM_PATH)/deferred_exec.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
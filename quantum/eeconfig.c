@@ -18,6 +18,10 @@ void via_eeprom_set_valid(bool valid);
 void eeconfig_init_via(void);
 #endif
 
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+void dynamic_keymap_flush(void);
+#endif
+
 /** \brief eeconfig enable
  *
  * FIXME: needs doc
@@ -38,6 +42,10 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
  * FIXME: needs doc
  */
 void eeconfig_init_quantum(void) {
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+    // Keep pending writes from landing after the erase, and reload the cache afterwards
+    dynamic_keymap_flush();
+#endif
 #if defined(EEPROM_DRIVER)
     eeprom_driver_erase();
 #endif
@@ -56,6 +64,10 @@ void eeconfig_init_quantum(void) {
     eeprom_update_byte(EECONFIG_VELOCIKEY, 0);
     eeprom_update_dword(EECONFIG_RGB_MATRIX, 0);
     eeprom_update_word(EECONFIG_RGB_MATRIX_EXTENDED, 0);
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+    // All zero makes pointer acceleration load its defaults
+    eeprom_update_dword(EECONFIG_POINTING_DEVICE_ACCEL, 0);
+#endif
 
     // TODO: Remove once ARM has a way to configure EECONFIG_HANDEDNESS
     //        within the emulated eeprom via dfu-util or another tool
@@ -107,6 +119,10 @@ void eeconfig_enable(void) {
  * FIXME: needs doc
  */
 void eeconfig_disable(void) {
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+    // Keep pending writes from landing after the erase, and reload the cache afterwards
+    dynamic_keymap_flush();
+#endif
 #if defined(EEPROM_DRIVER)
     eeprom_driver_erase();
 #endif
@@ -247,6 +263,23 @@ void eeconfig_update_haptic(uint32_t val) {
     eeprom_update_dword(EECONFIG_HAPTIC, val);
 }
 
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+/** \brief eeconfig read pointer acceleration
+ *
+ * FIXME: needs doc
+ */
+uint32_t eeconfig_read_pointing_device_accel(void) {
+    return eeprom_read_dword(EECONFIG_POINTING_DEVICE_ACCEL);
+}
+/** \brief eeconfig update pointer acceleration
+ *
+ * FIXME: needs doc
+ */
+void eeconfig_update_pointing_device_accel(uint32_t val) {
+    eeprom_update_dword(EECONFIG_POINTING_DEVICE_ACCEL, val);
+}
+#endif
+
 /** \brief eeconfig read split handedness
  *
  * FIXME: needs doc
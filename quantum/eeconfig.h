@@ -21,7 +21,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdbool.h>
 
 #ifndef EECONFIG_MAGIC_NUMBER
-#    define EECONFIG_MAGIC_NUMBER (uint16_t)0xFEE9 // When changing, decrement this value to avoid future re-init issues
+#    ifdef POINTING_DEVICE_ACCEL_ENABLE
+// Only firmwares with pointer acceleration use the larger layout, and reset to it
+#        define EECONFIG_MAGIC_NUMBER (uint16_t)0xFEE8
+#    else
+#        define EECONFIG_MAGIC_NUMBER (uint16_t)0xFEE9 // When changing, decrement this value to avoid future re-init issues
+#    endif
 #endif
 #define EECONFIG_MAGIC_NUMBER_OFF (uint16_t)0xFFFF
 
@@ -53,8 +58,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 // TODO: Combine these into a single word and single block of EEPROM
 #define EECONFIG_KEYMAP_UPPER_BYTE (uint8_t *)34
+
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    define EECONFIG_POINTING_DEVICE_ACCEL (uint32_t *)35
+// Size of EEPROM being used, other code can refer to this for available EEPROM
+#    define EECONFIG_SIZE 39
+#else
 // Size of EEPROM being used, other code can refer to this for available EEPROM
-#define EECONFIG_SIZE 35
+#    define EECONFIG_SIZE 35
+#endif
 /* debug bit */
 #define EECONFIG_DEBUG_ENABLE (1 << 0)
 #define EECONFIG_DEBUG_MATRIX (1 << 1)
@@ -109,6 +121,11 @@ uint32_t eeconfig_read_haptic(void);
 void     eeconfig_update_haptic(uint32_t val);
 #endif
 
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+uint32_t eeconfig_read_pointing_device_accel(void);
+void     eeconfig_update_pointing_device_accel(uint32_t val);
+#endif
+
 bool eeconfig_read_handedness(void);
 void eeconfig_update_handedness(bool val);
 
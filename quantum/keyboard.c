@@ -33,6 +33,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "scan_profiler.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -60,6 +64,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef POINTING_DEVICE_ENABLE
 #    include "pointing_device.h"
 #endif
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    include "pointing_device_accel.h"
+#endif
 #ifdef MIDI_ENABLE
 #    include "process_midi.h"
 #endif
@@ -104,11 +111,40 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 #ifdef SPLIT_KEYBOARD
 #    include "split_util.h"
+#    ifdef SPLIT_MATRIX_DELTA_SYNC
+#        include "transactions.h"
+#    endif
 #endif
 #ifdef BLUETOOTH_ENABLE
 #    include "outputselect.h"
 #endif
 
+#ifdef MATRIX_SCAN_THREAD
+#    if !defined(PROTOCOL_CHIBIOS)
+#        error "MATRIX_SCAN_THREAD is only supported on ChibiOS"
+#    endif
+#    ifdef SPLIT_KEYBOARD
+#        error "MATRIX_SCAN_THREAD is not supported on split keyboards, the split transport is part of the matrix scan"
+#    endif
+#    ifndef MATRIX_EVENT_QUEUE
+#        define MATRIX_EVENT_QUEUE
+#    endif
+#    ifndef MATRIX_SCAN_THREAD_INTERVAL_US
+#        define MATRIX_SCAN_THREAD_INTERVAL_US 1000
+#    endif
+#    ifndef MATRIX_SCAN_THREAD_STACK_SIZE
+#        define MATRIX_SCAN_THREAD_STACK_SIZE 512
+#    endif
+#    include <ch.h>
+
+static void matrix_scan_thread_start(void);
+
+// The scan thread queues the events from the matrix it scanned, not from the main thread's copy
+#    define matrix_event_row(row) matrix_get_scanned_row(row)
+#else
+#    define matrix_event_row(row) matrix_get_row(row)
+#endif
+
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
     return last_input_modification_time;
@@ -202,7 +238,7 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     we are checking one row at a time, not all of them at once.
     */
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)) {
+        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_event_row(i)) & rowdata)) {
             return true;
         }
     }
@@ -363,6 +399,12 @@ void quantum_init(void) {
 void keyboard_init(void) {
     timer_init();
     sync_timer_init();
+#ifdef SCAN_PROFILER_ENABLE
+    scan_profiler_init();
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+    latency_trace_init();
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -398,6 +440,10 @@ void keyboard_init(void) {
 #ifdef POINTING_DEVICE_ENABLE
     pointing_device_init();
 #endif
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+    // the master applies acceleration, whichever side the sensor is on
+    pointing_device_accel_init();
+#endif
 #if defined(NKRO_ENABLE) && defined(FORCE_NKRO)
     keymap_config.nkro = 1;
     eeconfig_update_keymap(keymap_config.raw);
@@ -418,6 +464,9 @@ void keyboard_init(void) {
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
     debug_enable = true;
 #endif
+#ifdef MATRIX_SCAN_THREAD
+    matrix_scan_thread_start();
+#endif
 
     keyboard_post_init_kb(); /* Always keep this last */
 }
@@ -436,6 +485,205 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_MATRIX_DELTA_SYNC)
+static uint16_t matrix_last_event_time = 0;
+#endif
+
+/** \brief Time at which a key changed state
+ *
+ * Uses the time recorded by the other half of a split keyboard when it is known, or the given time otherwise.
+ * The recorded time is kept between the previous event and the given time, so that a drifting sync timer can neither
+ * reorder events nor date them in the future.
+ */
+static inline uint16_t matrix_event_time(uint8_t row, uint8_t col, uint16_t time) {
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_MATRIX_DELTA_SYNC)
+    uint16_t key_time = split_matrix_key_time(row, col);
+    if (key_time) {
+        if (TIMER_DIFF_16(key_time, matrix_last_event_time) > TIMER_DIFF_16(time, matrix_last_event_time)) {
+            // Outside of the window, clamp to whichever end it is past
+            key_time = TIMER_DIFF_16(key_time, time) < 0x8000 ? time : matrix_last_event_time;
+        }
+        time = key_time | 1; /* time should not be 0 */
+    }
+    matrix_last_event_time = time;
+#endif
+    return time;
+}
+
+#ifdef MATRIX_EVENT_QUEUE
+#    ifndef MATRIX_EVENT_QUEUE_SIZE
+#        define MATRIX_EVENT_QUEUE_SIZE 16
+#    endif
+
+/* Single producer, single consumer ring: only the scan writes the head, and only key processing writes the tail. The
+ * acquire/release accesses make the queue safe to share between the scan thread and the main loop without locking. */
+static keyevent_t matrix_event_queue[MATRIX_EVENT_QUEUE_SIZE];
+static uint8_t    matrix_event_head = 0;
+static uint8_t    matrix_event_tail = 0;
+
+#    define QUEUE_INDEX_LOAD(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#    define QUEUE_INDEX_STORE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+/** \brief Queue the debounced changes produced by the last matrix scan
+ *
+ * Each event is stamped with the time of the scan that settled it, rather than the time it gets processed.
+ * If the queue fills up, the remaining changes stay pending in matrix_prev and are queued on the next scan.
+ */
+static void matrix_event_queue_changes(matrix_row_t matrix_prev[]) {
+    uint16_t time = timer_read() | 1; /* time should not be 0 */
+    uint8_t  head = matrix_event_head;
+    uint8_t  tail = QUEUE_INDEX_LOAD(matrix_event_tail);
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_row_t matrix_row    = matrix_event_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) {
+            continue;
+        }
+#    ifdef MATRIX_HAS_GHOST
+        if (has_ghost_in_row(r, matrix_row)) {
+            continue;
+        }
+#    endif
+#    ifndef MATRIX_SCAN_THREAD
+        if (debug_matrix) matrix_print();
+#    endif
+        while (matrix_change) {
+            uint8_t next = (head + 1) % MATRIX_EVENT_QUEUE_SIZE;
+            if (next == tail) {
+                return;
+            }
+
+            uint8_t      c        = matrix_row_ctz(matrix_change);
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << c;
+
+            matrix_event_queue[head] = (keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = matrix_event_time(r, c, time)};
+            head                     = next;
+            QUEUE_INDEX_STORE(matrix_event_head, head);
+
+            // record a queued key
+            matrix_prev[r] ^= col_mask;
+            matrix_change &= matrix_change - 1;
+        }
+    }
+}
+
+/** \brief Process queued matrix events
+ *
+ * Drains the whole queue (or up to QMK_KEYS_PER_SCAN events, if set) and returns the number of events processed.
+ */
+static uint8_t matrix_event_queue_process(void) {
+    uint8_t keys_processed = 0;
+
+    while (matrix_event_tail != QUEUE_INDEX_LOAD(matrix_event_head)) {
+        keyevent_t event = matrix_event_queue[matrix_event_tail];
+        QUEUE_INDEX_STORE(matrix_event_tail, (matrix_event_tail + 1) % MATRIX_EVENT_QUEUE_SIZE);
+
+        if (should_process_keypress()) {
+            action_exec(event);
+        }
+        switch_events(event.key.row, event.key.col, event.pressed);
+
+#    ifdef QMK_KEYS_PER_SCAN
+        if (++keys_processed >= QMK_KEYS_PER_SCAN) break;
+#    else
+        keys_processed++;
+#    endif
+    }
+
+    return keys_processed;
+}
+
+#    ifdef MATRIX_SCAN_THREAD
+/** \brief Scans the matrix at a fixed rate, independently of how long the main loop takes
+ *
+ * Debounced changes are queued for matrix_scan_task() to process on the main thread.
+ */
+static THD_WORKING_AREA(waMatrixScanThread, MATRIX_SCAN_THREAD_STACK_SIZE);
+
+/* Set by the scan thread when the matrix changed, the activity timestamps being updated from the main thread only */
+static volatile bool matrix_scan_thread_changed = false;
+
+static THD_FUNCTION(MatrixScanThread, arg) {
+    (void)arg;
+    chRegSetThreadName("matrix_scan");
+
+    static matrix_row_t matrix_prev[MATRIX_ROWS];
+    systime_t           time = chVTGetSystemTimeX();
+
+    while (true) {
+        uint8_t matrix_changed;
+        SCAN_PROFILE(PROFILE_MATRIX_SCAN, matrix_changed = matrix_scan());
+        matrix_publish();
+        if (matrix_changed) matrix_scan_thread_changed = true;
+
+        matrix_event_queue_changes(matrix_prev);
+
+        // Returns straight away if the scan overran its slot, catching up on the next one
+        time = chThdSleepUntilWindowed(time, chTimeAddX(time, TIME_US2I(MATRIX_SCAN_THREAD_INTERVAL_US)));
+    }
+}
+
+static void matrix_scan_thread_start(void) {
+    chThdCreateStatic(waMatrixScanThread, sizeof(waMatrixScanThread), HIGHPRIO, MatrixScanThread, NULL);
+}
+
+/** \brief Process the key events queued by the matrix scan thread
+ *
+ * The keyboard and user level scan hooks run here rather than from matrix_scan(), so that they stay on the main thread.
+ */
+bool matrix_scan_task(void) {
+    bool matrix_changed;
+
+    chSysLock();
+    bool scan_changed          = matrix_scan_thread_changed;
+    matrix_scan_thread_changed = false;
+    chSysUnlock();
+    if (scan_changed) last_matrix_activity_trigger();
+
+    // Everything on the main thread reads this copy until the next call
+    matrix_sync();
+
+    matrix_scan_quantum();
+
+    SCAN_PROFILE(PROFILE_KEY_PROCESSING, {
+        matrix_changed = matrix_event_queue_process();
+
+        // call with pseudo tick event when no real key event.
+        if (!matrix_changed) {
+            action_exec(TICK);
+        }
+    });
+
+    matrix_scan_perf_task();
+    return matrix_changed || scan_changed;
+}
+#    else
+/** \brief Perform scan of keyboard matrix
+ *
+ * Any detected changes in state are queued with their scan timestamp, then sent out as part of the processing
+ */
+bool matrix_scan_task(void) {
+    static matrix_row_t matrix_prev[MATRIX_ROWS];
+
+    uint8_t matrix_changed;
+    SCAN_PROFILE(PROFILE_MATRIX_SCAN, matrix_changed = matrix_scan());
+    if (matrix_changed) last_matrix_activity_trigger();
+
+    SCAN_PROFILE(PROFILE_KEY_PROCESSING, {
+        matrix_event_queue_changes(matrix_prev);
+
+        // call with pseudo tick event when no real key event.
+        if (!matrix_event_queue_process()) {
+            action_exec(TICK);
+        }
+    });
+
+    matrix_scan_perf_task();
+    return matrix_changed;
+}
+#    endif
+#else
 /** \brief Perform scan of keyboard matrix
  *
  * Any detected changes in state are sent out as part of the processing
@@ -448,9 +696,13 @@ bool matrix_scan_task(void) {
     uint8_t keys_processed = 0;
 #endif
 
-    uint8_t matrix_changed = matrix_scan();
+    uint8_t matrix_changed;
+    SCAN_PROFILE(PROFILE_MATRIX_SCAN, matrix_changed = matrix_scan());
     if (matrix_changed) last_matrix_activity_trigger();
 
+#ifdef SCAN_PROFILER_ENABLE
+    uint32_t key_processing_start = scan_profiler_now();
+#endif
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         matrix_row    = matrix_get_row(r);
         matrix_change = matrix_row ^ matrix_prev[r];
@@ -466,7 +718,7 @@ bool matrix_scan_task(void) {
                 if (matrix_change & col_mask) {
                     if (should_process_keypress()) {
                         action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
+                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = matrix_event_time(r, c, timer_read() | 1) /* time should not be 0 */
                         });
                     }
                     // record a processed key
@@ -492,10 +744,14 @@ bool matrix_scan_task(void) {
         action_exec(TICK);
 
 MATRIX_LOOP_END:
+#ifdef SCAN_PROFILER_ENABLE
+    scan_profiler_record(PROFILE_KEY_PROCESSING, scan_profiler_elapsed(key_processing_start));
+#endif
 
     matrix_scan_perf_task();
     return matrix_changed;
 }
+#endif
 
 /** \brief Tasks previously located in matrix_scan_quantum
  *
@@ -544,7 +800,7 @@ void quantum_task(void) {
 #endif
 
 #ifdef COMBO_ENABLE
-    combo_task();
+    SCAN_PROFILE(PROFILE_COMBO, combo_task());
 #endif
 
 #ifdef WPM_ENABLE
@@ -576,20 +832,23 @@ void quantum_task(void) {
  * This is repeatedly called as fast as possible.
  */
 void keyboard_task(void) {
+#ifdef SCAN_PROFILER_ENABLE
+    uint32_t keyboard_task_start = scan_profiler_now();
+#endif
     bool matrix_changed = matrix_scan_task();
     (void)matrix_changed;
 
-    quantum_task();
+    SCAN_PROFILE(PROFILE_QUANTUM_TASK, quantum_task());
 
 #if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
+    SCAN_PROFILE(PROFILE_RGBLIGHT, rgblight_task());
 #endif
 
 #ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
+    SCAN_PROFILE(PROFILE_LED_MATRIX, led_matrix_task());
 #endif
 #ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+    SCAN_PROFILE(PROFILE_RGB_MATRIX, rgb_matrix_task());
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
@@ -599,12 +858,13 @@ void keyboard_task(void) {
 #endif
 
 #ifdef ENCODER_ENABLE
-    bool encoders_changed = encoder_read();
+    bool encoders_changed;
+    SCAN_PROFILE(PROFILE_ENCODER, encoders_changed = encoder_read());
     if (encoders_changed) last_encoder_activity_trigger();
 #endif
 
 #ifdef OLED_ENABLE
-    oled_task();
+    SCAN_PROFILE(PROFILE_OLED, oled_task());
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
@@ -629,7 +889,7 @@ void keyboard_task(void) {
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
+    SCAN_PROFILE(PROFILE_MOUSEKEY, mousekey_task());
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
@@ -637,7 +897,7 @@ void keyboard_task(void) {
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
-    pointing_device_task();
+    SCAN_PROFILE(PROFILE_POINTING_DEVICE, pointing_device_task());
 #endif
 
 #ifdef MIDI_ENABLE
@@ -663,4 +923,12 @@ void keyboard_task(void) {
 #endif
 
     led_task();
+
+#ifdef LATENCY_TRACE_ENABLE
+    latency_trace_task();
+#endif
+
+#ifdef SCAN_PROFILER_ENABLE
+    scan_profiler_record(PROFILE_KEYBOARD_TASK, scan_profiler_elapsed(keyboard_task_start));
+#endif
 }
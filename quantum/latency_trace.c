@@ -0,0 +1,283 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "quantum.h"
+#include "latency_trace.h"
+
+#define LATENCY_TRACE_VERSION 0x01
+
+/* Last stage a key event is expected to reach; only ChibiOS reports when the host collected a report */
+#if defined(PROTOCOL_LUFA) || defined(PROTOCOL_VUSB) || defined(PROTOCOL_ARM_ATSAM)
+#    define LATENCY_TRACE_LAST_STAGE LATENCY_STAGE_REPORT
+#else
+#    define LATENCY_TRACE_LAST_STAGE LATENCY_STAGE_USB
+#endif
+
+#define STAGE_BIT(stage) (1 << (stage))
+#define TICKS_TO_US(ticks) ((uint32_t)((uint64_t)(ticks)*1000000 / LATENCY_TRACE_CLOCK_HZ))
+#define PRINTED_BIT (1 << 7)
+
+static matrix_row_t    previous_matrix[MATRIX_ROWS];
+static latency_trace_t traces[LATENCY_TRACE_SIZE];
+static uint8_t         trace_head  = 0;
+static uint8_t         trace_count = 0;
+
+#if defined(LATENCY_TRACE_TIMESTAMP)
+/* Externally provided clock, e.g. the simulated one of the test platform */
+#    ifndef LATENCY_TRACE_CLOCK_HZ
+#        define LATENCY_TRACE_CLOCK_HZ 1000000
+#    endif
+#    define LATENCY_TRACE_CLOCK_INIT()
+#elif defined(PROTOCOL_CHIBIOS) && defined(DWT_CTRL_CYCCNTENA_Msk)
+#    define LATENCY_TRACE_TIMESTAMP() DWT->CYCCNT
+#    define LATENCY_TRACE_CLOCK_HZ CPU_CLOCK
+#    define LATENCY_TRACE_CLOCK_INIT()                      \
+        do {                                                \
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; \
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;            \
+        } while (0)
+#elif defined(PROTOCOL_CHIBIOS)
+#    define LATENCY_TRACE_TIMESTAMP() chVTGetSystemTimeX()
+#    define LATENCY_TRACE_CLOCK_HZ CH_CFG_ST_FREQUENCY
+#    define LATENCY_TRACE_CLOCK_INIT()
+#else
+#    define LATENCY_TRACE_TIMESTAMP() timer_read32()
+#    define LATENCY_TRACE_CLOCK_HZ 1000
+#    define LATENCY_TRACE_CLOCK_INIT()
+#endif
+
+uint32_t latency_trace_timestamp(void) {
+    return LATENCY_TRACE_TIMESTAMP();
+}
+
+uint32_t latency_trace_clock_hz(void) {
+    return LATENCY_TRACE_CLOCK_HZ;
+}
+
+void latency_trace_init(void) {
+    LATENCY_TRACE_CLOCK_INIT();
+    latency_trace_clear();
+}
+
+void latency_trace_clear(void) {
+    ATOMIC_BLOCK_FORCEON {
+        trace_head  = 0;
+        trace_count = 0;
+    }
+}
+
+static inline latency_trace_t *trace_at(uint8_t index) {
+    return &traces[(trace_head - 1 - index) & (LATENCY_TRACE_SIZE - 1)];
+}
+
+static inline void trace_stamp(latency_trace_t *trace, latency_stage_t stage, uint32_t time) {
+    trace->time[stage] = time;
+    trace->stages |= STAGE_BIT(stage);
+}
+
+/* Starts tracing a key event, overwriting the oldest trace. Must be called atomically */
+static latency_trace_t *trace_start(keypos_t key, bool pressed) {
+    latency_trace_t *trace = &traces[trace_head];
+    trace_head             = (trace_head + 1) & (LATENCY_TRACE_SIZE - 1);
+    if (trace_count < LATENCY_TRACE_SIZE) {
+        trace_count++;
+    }
+
+    trace->key     = key;
+    trace->pressed = pressed;
+    trace->stages  = 0;
+    return trace;
+}
+
+/** \brief Timestamps the switches whose debounced state changed
+ *
+ * Called with the output of debounce(), first_row being the offset of these rows in the full matrix.
+ */
+void latency_trace_debounced(const matrix_row_t debounced[], uint8_t first_row, uint8_t num_rows) {
+    uint32_t      now      = LATENCY_TRACE_TIMESTAMP();
+    matrix_row_t *previous = &previous_matrix[first_row];
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t changes = previous[row] ^ debounced[row];
+        for (uint8_t col = 0; changes; col++, changes >>= 1) {
+            if (changes & 1) {
+                ATOMIC_BLOCK_FORCEON {
+                    latency_trace_t *trace = trace_start((keypos_t){.row = first_row + row, .col = col}, debounced[row] & ((matrix_row_t)1 << col));
+                    trace_stamp(trace, LATENCY_STAGE_DEBOUNCE, now);
+                }
+            }
+        }
+        previous[row] = debounced[row];
+    }
+}
+
+/** \brief Timestamps the start of processing of a key event
+ *
+ * Events that were not seen by the debouncer, such as those of the other half of a split keyboard, are traced from
+ * this point on.
+ */
+void latency_trace_action(keyevent_t event) {
+    if (IS_NOEVENT(event)) {
+        return;
+    }
+    uint32_t now = LATENCY_TRACE_TIMESTAMP();
+
+    ATOMIC_BLOCK_FORCEON {
+        latency_trace_t *trace = NULL;
+        for (uint8_t i = 0; i < trace_count; i++) {
+            latency_trace_t *candidate = trace_at(i);
+            if (KEYEQ(candidate->key, event.key) && candidate->pressed == event.pressed && candidate->stages == STAGE_BIT(LATENCY_STAGE_DEBOUNCE)) {
+                trace = candidate;
+                break;
+            }
+        }
+        if (!trace) {
+            trace = trace_start(event.key, event.pressed);
+        }
+        trace_stamp(trace, LATENCY_STAGE_ACTION, now);
+    }
+}
+
+/** \brief Timestamps a keyboard report being sent
+ *
+ * The report is attributed to every processed event still waiting for one. Events that do not change the report, such
+ * as layer keys, are therefore attributed to the next report sent.
+ */
+void latency_trace_report_sent(void) {
+    uint32_t now = LATENCY_TRACE_TIMESTAMP();
+
+    ATOMIC_BLOCK_FORCEON {
+        for (uint8_t i = 0; i < trace_count; i++) {
+            latency_trace_t *trace = trace_at(i);
+            if ((trace->stages & STAGE_BIT(LATENCY_STAGE_ACTION)) && !(trace->stages & STAGE_BIT(LATENCY_STAGE_REPORT))) {
+                trace_stamp(trace, LATENCY_STAGE_REPORT, now);
+            }
+        }
+    }
+}
+
+/** \brief Timestamps the host collecting the last keyboard report
+ *
+ * Called from the USB IN completion interrupt.
+ */
+void latency_trace_report_delivered(void) {
+    uint32_t now = LATENCY_TRACE_TIMESTAMP();
+
+    for (uint8_t i = 0; i < trace_count; i++) {
+        latency_trace_t *trace = trace_at(i);
+        if ((trace->stages & STAGE_BIT(LATENCY_STAGE_REPORT)) && !(trace->stages & STAGE_BIT(LATENCY_STAGE_USB))) {
+            trace_stamp(trace, LATENCY_STAGE_USB, now);
+        }
+    }
+}
+
+/** \brief Copies a trace, index 0 being the latest
+ *
+ * Returns false if there is no such trace.
+ */
+bool latency_trace_get(uint8_t index, latency_trace_t *trace) {
+    bool found = false;
+    ATOMIC_BLOCK_FORCEON {
+        if (index < trace_count) {
+            *trace = *trace_at(index);
+            trace->stages &= ~PRINTED_BIT;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/** \brief Prints the latency breakdown of each completed trace to the console, when debugging is enabled */
+void latency_trace_task(void) {
+    if (!debug_enable) {
+        return;
+    }
+
+    for (uint8_t i = trace_count; i-- > 0;) {
+        latency_trace_t trace;
+        ATOMIC_BLOCK_FORCEON {
+            latency_trace_t *entry = trace_at(i);
+            trace                  = *entry;
+            if (entry->stages & STAGE_BIT(LATENCY_TRACE_LAST_STAGE)) {
+                entry->stages |= PRINTED_BIT;
+            }
+        }
+        if (!(trace.stages & STAGE_BIT(LATENCY_TRACE_LAST_STAGE)) || (trace.stages & PRINTED_BIT)) {
+            continue;
+        }
+
+        dprintf("latency %u/%u %s:", trace.key.row, trace.key.col, trace.pressed ? "down" : "up");
+        latency_stage_t first = (trace.stages & STAGE_BIT(LATENCY_STAGE_DEBOUNCE)) ? LATENCY_STAGE_DEBOUNCE : LATENCY_STAGE_ACTION;
+        for (latency_stage_t stage = first + 1; stage <= LATENCY_TRACE_LAST_STAGE; stage++) {
+            dprintf(" +%luus", TICKS_TO_US(trace.time[stage] - trace.time[stage - 1]));
+        }
+        dprintf(" = %luus\n", TICKS_TO_US(trace.time[LATENCY_TRACE_LAST_STAGE] - trace.time[first]));
+    }
+}
+
+static uint8_t *put_uint32(uint8_t *buf, uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        *buf++ = value >> (8 * i);
+    }
+    return buf;
+}
+
+/** \brief Handles a latency trace request in place
+ *
+ * Returns false if the packet is not addressed to the latency trace. Otherwise the reply overwrites the request,
+ * with the command byte set to 0xFF when it could not be handled.
+ */
+bool latency_trace_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != LATENCY_TRACE_RAW_HID_ID) {
+        return false;
+    }
+
+    uint8_t *reply = &data[2];
+    switch (data[1]) {
+        case id_latency_trace_get_info: {
+            *reply++ = LATENCY_TRACE_VERSION;
+            *reply++ = LATENCY_TRACE_SIZE;
+            *reply++ = LATENCY_STAGE_COUNT;
+            put_uint32(reply, LATENCY_TRACE_CLOCK_HZ);
+            break;
+        }
+        case id_latency_trace_get_trace: {
+            latency_trace_t trace;
+            if (length < 7 + 4 * LATENCY_STAGE_COUNT || !latency_trace_get(*reply++, &trace)) {
+                data[1] = 0xFF;
+                break;
+            }
+            *reply++ = trace.key.row;
+            *reply++ = trace.key.col;
+            *reply++ = trace.pressed;
+            *reply++ = trace.stages;
+            for (uint8_t stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+                reply = put_uint32(reply, trace.time[stage]);
+            }
+            break;
+        }
+        case id_latency_trace_clear: {
+            latency_trace_clear();
+            break;
+        }
+        default: {
+            data[1] = 0xFF;
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "keyboard.h"
+#include "matrix.h"
+
+#ifndef LATENCY_TRACE_SIZE
+#    define LATENCY_TRACE_SIZE 16
+#endif
+
+#if (LATENCY_TRACE_SIZE & (LATENCY_TRACE_SIZE - 1)) != 0
+#    error "LATENCY_TRACE_SIZE must be a power of two"
+#endif
+
+#ifndef LATENCY_TRACE_RAW_HID_ID
+#    define LATENCY_TRACE_RAW_HID_ID 0xF1
+#endif
+
+/* Points along the path from switch to host at which a key event is timestamped */
+typedef enum {
+    LATENCY_STAGE_DEBOUNCE, // debounced state of the switch changed
+    LATENCY_STAGE_ACTION,   // action_exec() started processing the event
+    LATENCY_STAGE_REPORT,   // a changed keyboard report was handed to the host driver
+    LATENCY_STAGE_USB,      // the host collected the report (ChibiOS only)
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint8_t  stages; // bitmask of the stages recorded in time[]
+    uint32_t time[LATENCY_STAGE_COUNT];
+} latency_trace_t;
+
+/* raw HID sub-commands, sent as [LATENCY_TRACE_RAW_HID_ID, command, args...] */
+enum latency_trace_command_id {
+    id_latency_trace_get_info  = 0x01, // -> version, trace size, stage count, clock rate (Hz, little endian)
+    id_latency_trace_get_trace = 0x02, // index (0 is the latest) -> row, col, pressed, stages, stage times (little endian)
+    id_latency_trace_clear     = 0x03,
+};
+
+uint32_t latency_trace_timestamp(void);
+uint32_t latency_trace_clock_hz(void);
+void     latency_trace_init(void);
+void     latency_trace_task(void);
+void     latency_trace_clear(void);
+bool     latency_trace_get(uint8_t index, latency_trace_t *trace);
+void     latency_trace_debounced(const matrix_row_t debounced[], uint8_t first_row, uint8_t num_rows);
+void     latency_trace_action(keyevent_t event);
+void     latency_trace_report_sent(void);
+void     latency_trace_report_delivered(void);
+bool     latency_trace_raw_hid_receive(uint8_t *data, uint8_t length);
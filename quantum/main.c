@@ -47,6 +47,10 @@ void protocol_task(void) {
 void deferred_exec_task(void);
 #endif // DEFERRED_EXEC_ENABLE
 
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+void dynamic_keymap_task(void);
+#endif // defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+
 /** \brief Main
  *
  * FIXME: Needs doc
@@ -68,6 +72,11 @@ int main(void) {
         deferred_exec_task();
 #endif // DEFERRED_EXEC_ENABLE
 
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+        // Write back dynamic keymap changes
+        dynamic_keymap_task();
+#endif // defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+
         housekeeping_task();
     }
 }
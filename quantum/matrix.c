@@ -21,6 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#include "scan_profiler.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -337,11 +341,20 @@ uint8_t matrix_scan(void) {
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
 
 #ifdef SPLIT_KEYBOARD
-    debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+    SCAN_PROFILE(PROFILE_DEBOUNCE, debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed));
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_debounced(matrix + thisHand, thisHand, ROWS_PER_HAND);
+#    endif
     changed = (changed || matrix_post_scan());
 #else
-    debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    SCAN_PROFILE(PROFILE_DEBOUNCE, debounce(raw_matrix, matrix, ROWS_PER_HAND, changed));
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_debounced(matrix, 0, ROWS_PER_HAND);
+#    endif
+#    ifndef MATRIX_SCAN_THREAD
+    // with a scan thread, keyboard_task() calls this from the main thread instead
     matrix_scan_quantum();
+#    endif
 #endif
     return (uint8_t)changed;
 }
@@ -32,6 +32,15 @@ typedef uint32_t matrix_row_t;
 
 #define MATRIX_ROW_SHIFTER ((matrix_row_t)1)
 
+/* index of the lowest set column of a non-zero row */
+static inline uint8_t matrix_row_ctz(matrix_row_t bits) {
+#if (MATRIX_COLS <= 16)
+    return __builtin_ctz(bits);
+#else
+    return __builtin_ctzl(bits);
+#endif
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -50,6 +59,13 @@ uint8_t matrix_scan(void);
 bool matrix_is_on(uint8_t row, uint8_t col);
 /* matrix state on row */
 matrix_row_t matrix_get_row(uint8_t row);
+#ifdef MATRIX_SCAN_THREAD
+/* matrix state on row, for the scan thread */
+matrix_row_t matrix_get_scanned_row(uint8_t row);
+/* hand the last scan over from the scan thread to the main thread */
+void matrix_publish(void);
+void matrix_sync(void);
+#endif
 /* print matrix for debug */
 void matrix_print(void);
 /* delay between changing matrix pin state and reading values */
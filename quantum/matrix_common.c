@@ -4,6 +4,10 @@
 #include "wait.h"
 #include "print.h"
 #include "debug.h"
+#include "scan_profiler.h"
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -22,6 +26,19 @@
 matrix_row_t raw_matrix[MATRIX_ROWS];
 matrix_row_t matrix[MATRIX_ROWS];
 
+#ifdef MATRIX_SCAN_THREAD
+#    include <string.h>
+#    include <ch.h>
+
+/* matrix[] belongs to the scan thread, which publishes it after each scan. The main thread reads its own copy, taken
+ * by matrix_sync(), so that it sees the same matrix for a whole pass of the main loop. */
+static matrix_row_t matrix_published[MATRIX_ROWS];
+static matrix_row_t matrix_snapshot[MATRIX_ROWS];
+#    define matrix_view matrix_snapshot
+#else
+#    define matrix_view matrix
+#endif
+
 #ifdef SPLIT_KEYBOARD
 // row offsets for each hand
 uint8_t thisHand, thatHand;
@@ -56,19 +73,44 @@ inline uint8_t matrix_cols(void) {
 }
 
 inline bool matrix_is_on(uint8_t row, uint8_t col) {
-    return (matrix[row] & ((matrix_row_t)1 << col));
+    return (matrix_view[row] & ((matrix_row_t)1 << col));
 }
 
 inline matrix_row_t matrix_get_row(uint8_t row) {
     // Matrix mask lets you disable switches in the returned matrix data. For example, if you have a
     // switch blocker installed and the switch is always pressed.
 #ifdef MATRIX_MASKED
-    return matrix[row] & matrix_mask[row];
+    return matrix_view[row] & matrix_mask[row];
 #else
-    return matrix[row];
+    return matrix_view[row];
 #endif
 }
 
+#ifdef MATRIX_SCAN_THREAD
+/* matrix_get_row() for the scan thread, straight from the matrix it just scanned */
+matrix_row_t matrix_get_scanned_row(uint8_t row) {
+#    ifdef MATRIX_MASKED
+    return matrix[row] & matrix_mask[row];
+#    else
+    return matrix[row];
+#    endif
+}
+
+/* Called by the scan thread once a scan is complete */
+void matrix_publish(void) {
+    chSysLock();
+    memcpy(matrix_published, matrix, sizeof(matrix_published));
+    chSysUnlock();
+}
+
+/* Called by the main thread to pick up the last complete scan */
+void matrix_sync(void) {
+    chSysLock();
+    memcpy(matrix_snapshot, matrix_published, sizeof(matrix_snapshot));
+    chSysUnlock();
+}
+#endif
+
 #if (MATRIX_COLS <= 8)
 #    define print_matrix_header() print("\nr/c 01234567\n")
 #    define print_matrix_row(row) print_bin_reverse8(matrix_get_row(row))
@@ -97,7 +139,9 @@ bool matrix_post_scan(void) {
     if (is_keyboard_master()) {
         static bool  last_connected              = false;
         matrix_row_t slave_matrix[ROWS_PER_HAND] = {0};
-        if (transport_master_if_connected(matrix + thisHand, slave_matrix)) {
+        bool         connected;
+        SCAN_PROFILE(PROFILE_SPLIT_TRANSPORT, connected = transport_master_if_connected(matrix + thisHand, slave_matrix));
+        if (connected) {
             changed = memcmp(matrix + thatHand, slave_matrix, sizeof(slave_matrix)) != 0;
 
             last_connected = true;
@@ -113,7 +157,7 @@ bool matrix_post_scan(void) {
 
         matrix_scan_quantum();
     } else {
-        transport_slave(matrix + thatHand, matrix + thisHand);
+        SCAN_PROFILE(PROFILE_SPLIT_TRANSPORT, transport_slave(matrix + thatHand, matrix + thisHand));
 
         matrix_slave_scan_kb();
     }
@@ -169,16 +213,25 @@ __attribute__((weak)) uint8_t matrix_scan(void) {
     bool changed = matrix_scan_custom(raw_matrix);
 
 #ifdef SPLIT_KEYBOARD
-    debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+    SCAN_PROFILE(PROFILE_DEBOUNCE, debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed));
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_debounced(matrix + thisHand, thisHand, ROWS_PER_HAND);
+#    endif
     changed = (changed || matrix_post_scan());
 #else
-    debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    SCAN_PROFILE(PROFILE_DEBOUNCE, debounce(raw_matrix, matrix, ROWS_PER_HAND, changed));
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_debounced(matrix, 0, ROWS_PER_HAND);
+#    endif
+#    ifndef MATRIX_SCAN_THREAD
+    // with a scan thread, keyboard_task() calls this from the main thread instead
     matrix_scan_quantum();
+#    endif
 #endif
 
     return changed;
 }
 
 __attribute__((weak)) bool peek_matrix(uint8_t row_index, uint8_t col_index, bool raw) {
-    return 0 != ((raw ? raw_matrix[row_index] : matrix[row_index]) & (MATRIX_ROW_SHIFTER << col_index));
+    return 0 != ((raw ? raw_matrix[row_index] : matrix_view[row_index]) & (MATRIX_ROW_SHIFTER << col_index));
 }
@@ -458,7 +458,14 @@ void mousekey_send(void) {
     uint16_t time = timer_read();
     if (mouse_report.x || mouse_report.y) last_timer_c = time;
     if (mouse_report.v || mouse_report.h) last_timer_w = time;
+#ifdef MOUSE_HIRES_SCROLL
+    // wheel speeds are in detents, the host may count finer units
+    report_mouse_t report = mouse_report;
+    host_mouse_scale_detents(&report);
+    host_mouse_send(&report);
+#else
     host_mouse_send(&mouse_report);
+#endif
 }
 
 void mousekey_clear(void) {
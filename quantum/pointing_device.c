@@ -22,6 +22,12 @@
 #ifdef MOUSEKEY_ENABLE
 #    include "mousekey.h"
 #endif
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    include "pointing_device_accel.h"
+#endif
+#ifdef POINTING_DEVICE_MODES_ENABLE
+#    include "pointing_device_modes.h"
+#endif
 #if (defined(POINTING_DEVICE_ROTATION_90) + defined(POINTING_DEVICE_ROTATION_180) + defined(POINTING_DEVICE_ROTATION_270)) > 1
 #    error More than one rotation selected.  This is not supported.
 #endif
@@ -188,7 +194,7 @@ __attribute__((weak)) void pointing_device_send(void) {
 report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report) {
     // Support rotation of the sensor data
 #if defined(POINTING_DEVICE_ROTATION_90) || defined(POINTING_DEVICE_ROTATION_180) || defined(POINTING_DEVICE_ROTATION_270)
-    int8_t x = mouse_report.x, y = mouse_report.y;
+    mouse_xy_report_t x = mouse_report.x, y = mouse_report.y;
 #    if defined(POINTING_DEVICE_ROTATION_90)
     mouse_report.x = y;
     mouse_report.y = -x;
@@ -227,6 +233,11 @@ __attribute__((weak)) void pointing_device_task(void) {
     };
 #endif
 
+#ifdef POINTING_DEVICE_MODES_ENABLE
+    // caret taps are paced by their own timer, not by the sensor polling rate
+    pointing_device_modes_task();
+#endif
+
 #if (POINTING_DEVICE_TASK_THROTTLE_MS > 0)
     static uint32_t last_exec = 0;
     if (timer_elapsed32(last_exec) < POINTING_DEVICE_TASK_THROTTLE_MS) {
@@ -236,7 +247,7 @@ __attribute__((weak)) void pointing_device_task(void) {
 #endif
 
     // Gather report info
-#ifdef POINTING_DEVICE_MOTION_PIN
+#if defined(POINTING_DEVICE_MOTION_PIN) && !defined(PMW3360_MOTION_INTERRUPT)
 #    if defined(SPLIT_POINTING_ENABLE)
 #        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
 #    endif
@@ -271,6 +282,16 @@ __attribute__((weak)) void pointing_device_task(void) {
 #else
     local_mouse_report = pointing_device_adjust_by_defines(local_mouse_report);
     local_mouse_report = pointing_device_task_kb(local_mouse_report);
+#endif
+#ifdef MOUSE_HIRES_SCROLL
+    // wheel motion from the driver and the kb/user hooks is in detents, scroll mode adds finer units after this
+    host_mouse_scale_detents(&local_mouse_report);
+#endif
+#ifdef POINTING_DEVICE_MODES_ENABLE
+    local_mouse_report = pointing_device_modes_apply(local_mouse_report);
+#endif
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+    local_mouse_report = pointing_device_accel_apply(local_mouse_report);
 #endif
     // combine with mouse report to ensure that the combined is sent correctly
 #ifdef MOUSEKEY_ENABLE
@@ -368,10 +389,26 @@ static inline int8_t pointing_device_movement_clamp(int16_t value) {
     }
 }
 
+/**
+ * @brief clamps int32_t to the range of the report x and y axes
+ *
+ * @param[in] int32_t value
+ * @return mouse_xy_report_t clamped value
+ */
+static inline mouse_xy_report_t pointing_device_xy_clamp(int32_t value) {
+    if (value < MOUSE_REPORT_XY_MIN) {
+        return MOUSE_REPORT_XY_MIN;
+    } else if (value > MOUSE_REPORT_XY_MAX) {
+        return MOUSE_REPORT_XY_MAX;
+    } else {
+        return value;
+    }
+}
+
 /**
  * @brief combines 2 mouse reports and returns 2
  *
- * Combines 2 report_mouse_t structs, clamping movement values to int8_t and ignores report_id then returns the resulting report_mouse_t struct.
+ * Combines 2 report_mouse_t structs, clamping movement values to the report range and ignores report_id then returns the resulting report_mouse_t struct.
  *
  * NOTE: Only available when using SPLIT_POINTING_ENABLE and POINTING_DEVICE_COMBINED
  *
@@ -380,8 +417,8 @@ static inline int8_t pointing_device_movement_clamp(int16_t value) {
  * @return combined report_mouse_t of left_report and right_report
  */
 report_mouse_t pointing_device_combine_reports(report_mouse_t left_report, report_mouse_t right_report) {
-    left_report.x = pointing_device_movement_clamp((int16_t)left_report.x + right_report.x);
-    left_report.y = pointing_device_movement_clamp((int16_t)left_report.y + right_report.y);
+    left_report.x = pointing_device_xy_clamp((int32_t)left_report.x + right_report.x);
+    left_report.y = pointing_device_xy_clamp((int32_t)left_report.y + right_report.y);
     left_report.h = pointing_device_movement_clamp((int16_t)left_report.h + right_report.h);
     left_report.v = pointing_device_movement_clamp((int16_t)left_report.v + right_report.v);
     left_report.buttons |= right_report.buttons;
@@ -401,7 +438,7 @@ report_mouse_t pointing_device_combine_reports(report_mouse_t left_report, repor
 report_mouse_t pointing_device_adjust_by_defines_right(report_mouse_t mouse_report) {
     // Support rotation of the sensor data
 #    if defined(POINTING_DEVICE_ROTATION_90_RIGHT) || defined(POINTING_DEVICE_ROTATION_RIGHT) || defined(POINTING_DEVICE_ROTATION_RIGHT)
-    int8_t x = mouse_report.x, y = mouse_report.y;
+    mouse_xy_report_t x = mouse_report.x, y = mouse_report.y;
 #        if defined(POINTING_DEVICE_ROTATION_90_RIGHT)
     mouse_report.x = y;
     mouse_report.y = -x;
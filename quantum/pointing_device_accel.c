@@ -0,0 +1,220 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "pointing_device_accel.h"
+#include "eeconfig.h"
+#include "progmem.h"
+#include "timer.h"
+
+/* Factors are fixed point, with 8 fractional bits */
+#define FACTOR_ONE 256
+
+/* Speed/factor points of the custom curve, by increasing speed. Interpolated linearly in between */
+#ifndef POINTING_DEVICE_ACCEL_CUSTOM_POINTS
+#    define POINTING_DEVICE_ACCEL_CUSTOM_POINTS \
+        {                                       \
+            { 0, 16 }                           \
+        }
+#endif
+
+static const pointing_device_accel_point_t custom_points[] PROGMEM = POINTING_DEVICE_ACCEL_CUSTOM_POINTS;
+
+#define CUSTOM_POINT_COUNT (sizeof(custom_points) / sizeof(custom_points[0]))
+
+static pointing_device_accel_config_t accel_config;
+static uint16_t                       factors[256];
+static int16_t                        remainder_x = 0, remainder_y = 0;
+static uint32_t                       last_motion = 0;
+static uint16_t                       sample_time = 0;
+static bool                           have_sample = false; // sample_time was set for the next report
+
+static const pointing_device_accel_config_t default_config = {
+    .enable   = true,
+    .curve    = POINTING_DEVICE_ACCEL_DEFAULT_CURVE,
+    .exponent = POINTING_DEVICE_ACCEL_DEFAULT_EXPONENT,
+    .offset   = POINTING_DEVICE_ACCEL_DEFAULT_OFFSET,
+    .rate     = POINTING_DEVICE_ACCEL_DEFAULT_RATE,
+    .limit    = POINTING_DEVICE_ACCEL_DEFAULT_LIMIT,
+};
+
+static bool config_is_valid(pointing_device_accel_config_t config) {
+    return config.limit != 0 && config.curve < POINTING_DEVICE_ACCEL_CURVE_COUNT;
+}
+
+static float custom_factor(uint8_t speed) {
+    uint8_t prev_speed  = pgm_read_byte(&custom_points[0].speed);
+    uint8_t prev_factor = pgm_read_byte(&custom_points[0].factor);
+    if (speed <= prev_speed) {
+        return prev_factor / 16.0f;
+    }
+
+    for (uint8_t i = 1; i < CUSTOM_POINT_COUNT; i++) {
+        uint8_t next_speed  = pgm_read_byte(&custom_points[i].speed);
+        uint8_t next_factor = pgm_read_byte(&custom_points[i].factor);
+        if (speed <= next_speed) {
+            return (prev_factor + (float)(next_factor - prev_factor) * (speed - prev_speed) / (next_speed - prev_speed)) / 16.0f;
+        }
+        prev_speed  = next_speed;
+        prev_factor = next_factor;
+    }
+    return prev_factor / 16.0f;
+}
+
+static uint16_t curve_factor(uint8_t speed) {
+    float over   = speed > accel_config.offset ? speed - accel_config.offset : 0;
+    float limit  = accel_config.limit / 16.0f;
+    float factor = 1.0f;
+
+    switch (accel_config.curve) {
+        case POINTING_DEVICE_ACCEL_CURVE_LINEAR:
+            factor = 1.0f + accel_config.rate * over / 256.0f;
+            break;
+        case POINTING_DEVICE_ACCEL_CURVE_POWER:
+            factor = 1.0f + powf(accel_config.rate * over / 256.0f, 1.0f + accel_config.exponent / 4.0f);
+            break;
+        case POINTING_DEVICE_ACCEL_CURVE_SIGMOID:
+            factor = 1.0f + (limit - 1.0f) / (1.0f + expf(accel_config.rate / 64.0f * ((float)accel_config.offset - speed)));
+            break;
+        case POINTING_DEVICE_ACCEL_CURVE_CUSTOM:
+            factor = custom_factor(speed);
+            break;
+    }
+    if (factor > limit) {
+        factor = limit;
+    }
+    return factor * FACTOR_ONE + 0.5f;
+}
+
+/* Evaluates the curve once per speed, so that accelerating a report is a lookup */
+static void build_factors(void) {
+    for (uint16_t speed = 0; speed < 256; speed++) {
+        factors[speed] = curve_factor(speed);
+    }
+}
+
+/** \brief Loads the acceleration settings from EEPROM, resetting them to the defaults if they are not valid */
+void pointing_device_accel_init(void) {
+    accel_config.raw = eeconfig_read_pointing_device_accel();
+    if (!config_is_valid(accel_config)) {
+        accel_config = default_config;
+        eeconfig_update_pointing_device_accel(accel_config.raw);
+    }
+    build_factors();
+    remainder_x = remainder_y = 0;
+    last_motion               = 0;
+    have_sample               = false;
+}
+
+pointing_device_accel_config_t pointing_device_accel_get_config(void) {
+    return accel_config;
+}
+
+/** \brief Changes the acceleration settings without saving them. Invalid settings are ignored */
+void pointing_device_accel_set_config_noeeprom(pointing_device_accel_config_t config) {
+    if (!config_is_valid(config)) {
+        return;
+    }
+
+    // Turning acceleration on or off leaves the curve as it is
+    pointing_device_accel_config_t curve = config;
+    curve.enable                         = accel_config.enable;
+    bool curve_changed                   = curve.raw != accel_config.raw;
+
+    accel_config = config;
+    if (curve_changed) {
+        build_factors();
+    }
+}
+
+/** \brief Changes the acceleration settings and saves them to EEPROM */
+void pointing_device_accel_set_config(pointing_device_accel_config_t config) {
+    pointing_device_accel_set_config_noeeprom(config);
+    eeconfig_update_pointing_device_accel(accel_config.raw);
+}
+
+bool pointing_device_accel_is_enabled(void) {
+    return accel_config.enable;
+}
+
+void pointing_device_accel_toggle(void) {
+    accel_config.enable = !accel_config.enable;
+    eeconfig_update_pointing_device_accel(accel_config.raw);
+}
+
+/** \brief Tells when the sensor sampled the last motion of the next report, as returned by timer_read()
+ *
+ * For drivers that timestamp their samples. Otherwise the motion is considered sampled when the report is accelerated.
+ */
+void pointing_device_accel_set_sample_time(uint16_t time) {
+    sample_time = time;
+    have_sample = true;
+}
+
+/** \brief Returns the factor motion is multiplied by at a speed, with 8 fractional bits */
+uint16_t pointing_device_accel_get_factor(uint8_t speed) {
+    return factors[speed];
+}
+
+static mouse_xy_report_t accelerate(mouse_xy_report_t value, uint16_t factor, int16_t *remainder) {
+    // Fractions of counts are kept for the next report rather than rounded away
+    int32_t scaled = (int32_t)value * factor + *remainder;
+    int32_t result = scaled / FACTOR_ONE;
+    *remainder     = scaled - result * FACTOR_ONE;
+
+    if (result > MOUSE_REPORT_XY_MAX) {
+        return MOUSE_REPORT_XY_MAX;
+    } else if (result < MOUSE_REPORT_XY_MIN) {
+        return MOUSE_REPORT_XY_MIN;
+    }
+    return result;
+}
+
+/** \brief Accelerates the motion of a report according to its speed
+ *
+ * The speed is the distance moved since the previous report with motion, divided by the time between the samples of
+ * both reports.
+ */
+report_mouse_t pointing_device_accel_apply(report_mouse_t mouse_report) {
+    bool has_sample_time = have_sample;
+    have_sample          = false;
+    if (!accel_config.enable || (!mouse_report.x && !mouse_report.y)) {
+        return mouse_report;
+    }
+
+    uint32_t now = timer_read32();
+    if (has_sample_time) {
+        // The sample is only a few milliseconds old, a 16 bit difference is enough
+        now -= TIMER_DIFF_16((uint16_t)now, sample_time);
+    }
+    uint32_t elapsed = now - last_motion;
+    last_motion      = now;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    // Distance approximated as the larger plus 3/8 of the smaller axis, within 7% of the actual one
+    uint32_t dx       = abs(mouse_report.x);
+    uint32_t dy       = abs(mouse_report.y);
+    uint32_t distance = dx > dy ? dx + dy * 3 / 8 : dy + dx * 3 / 8;
+    uint32_t speed    = distance * POINTING_DEVICE_ACCEL_SPEED_SCALE / elapsed;
+    uint16_t factor   = factors[speed > 255 ? 255 : speed];
+
+    mouse_report.x = accelerate(mouse_report.x, factor, &remainder_x);
+    mouse_report.y = accelerate(mouse_report.y, factor, &remainder_y);
+    return mouse_report;
+}
@@ -0,0 +1,78 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+/* Speeds are measured in counts per millisecond, multiplied by this value */
+#ifndef POINTING_DEVICE_ACCEL_SPEED_SCALE
+#    define POINTING_DEVICE_ACCEL_SPEED_SCALE 4
+#endif
+
+typedef enum {
+    POINTING_DEVICE_ACCEL_CURVE_LINEAR,
+    POINTING_DEVICE_ACCEL_CURVE_POWER,
+    POINTING_DEVICE_ACCEL_CURVE_SIGMOID,
+    POINTING_DEVICE_ACCEL_CURVE_CUSTOM,
+    POINTING_DEVICE_ACCEL_CURVE_COUNT
+} pointing_device_accel_curve_t;
+
+#ifndef POINTING_DEVICE_ACCEL_DEFAULT_CURVE
+#    define POINTING_DEVICE_ACCEL_DEFAULT_CURVE POINTING_DEVICE_ACCEL_CURVE_LINEAR
+#endif
+#ifndef POINTING_DEVICE_ACCEL_DEFAULT_OFFSET
+#    define POINTING_DEVICE_ACCEL_DEFAULT_OFFSET 8
+#endif
+#ifndef POINTING_DEVICE_ACCEL_DEFAULT_RATE
+#    define POINTING_DEVICE_ACCEL_DEFAULT_RATE 16
+#endif
+#ifndef POINTING_DEVICE_ACCEL_DEFAULT_LIMIT
+#    define POINTING_DEVICE_ACCEL_DEFAULT_LIMIT 48
+#endif
+#ifndef POINTING_DEVICE_ACCEL_DEFAULT_EXPONENT
+#    define POINTING_DEVICE_ACCEL_DEFAULT_EXPONENT 4
+#endif
+
+typedef union {
+    uint32_t raw;
+    struct {
+        bool    enable : 1;
+        uint8_t curve : 3;    // pointing_device_accel_curve_t
+        uint8_t exponent : 4; // power curve exponent above 1, in 1/4
+        uint8_t offset;       // speed at which the factor starts to grow, or for the sigmoid reaches half its range
+        uint8_t rate;         // growth of the factor with speed
+        uint8_t limit;        // highest factor, in 1/16, must not be 0
+    } __attribute__((packed));
+} pointing_device_accel_config_t;
+
+/* A point of the custom curve: above speed, motion is multiplied by factor/16 */
+typedef struct {
+    uint8_t speed;
+    uint8_t factor;
+} pointing_device_accel_point_t;
+
+void                           pointing_device_accel_init(void);
+pointing_device_accel_config_t pointing_device_accel_get_config(void);
+void                           pointing_device_accel_set_config(pointing_device_accel_config_t config);
+void                           pointing_device_accel_set_config_noeeprom(pointing_device_accel_config_t config);
+bool                           pointing_device_accel_is_enabled(void);
+void                           pointing_device_accel_toggle(void);
+void                           pointing_device_accel_set_sample_time(uint16_t time);
+uint16_t                       pointing_device_accel_get_factor(uint8_t speed);
+report_mouse_t                 pointing_device_accel_apply(report_mouse_t mouse_report);
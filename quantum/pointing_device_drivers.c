@@ -21,9 +21,29 @@
 #include "wait.h"
 #include "timer.h"
 #include <stddef.h>
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    include "pointing_device_accel.h"
+#endif
+#if defined(POINTING_DEVICE_DRIVER_pmw3360) && defined(PMW3360_MOTION_INTERRUPT) && defined(USB_MOUSE_COALESCE)
+#    include "usb_main.h"
+#endif
 
-// hid mouse reports cannot exceed -127 to 127, so constrain to that value
-#define constrain_hid(amt) ((amt) < -127 ? -127 : ((amt) > 127 ? 127 : (amt)))
+// hid mouse reports cannot exceed MOUSE_REPORT_XY_MIN to MOUSE_REPORT_XY_MAX, so constrain to that value
+#define constrain_hid(amt) ((amt) < MOUSE_REPORT_XY_MIN ? MOUSE_REPORT_XY_MIN : ((amt) > MOUSE_REPORT_XY_MAX ? MOUSE_REPORT_XY_MAX : (amt)))
+
+/* Adds sensor motion to the counts still pending for an axis and moves as much of them into the report as it can
+ * hold. Motion beyond the report range is sent with the following reports instead of being dropped. */
+static inline mouse_xy_report_t constrain_hid_carry(int16_t *pending, int32_t motion) {
+    int32_t total = *pending + motion;
+    if (total > INT16_MAX) {
+        total = INT16_MAX;
+    } else if (total < INT16_MIN) {
+        total = INT16_MIN;
+    }
+    mouse_xy_report_t report = constrain_hid(total);
+    *pending                 = total - report;
+    return report;
+}
 
 // get_report functions should probably be moved to their respective drivers.
 #if defined(POINTING_DEVICE_DRIVER_adns5050)
@@ -54,12 +74,10 @@ const pointing_device_driver_t pointing_device_driver = {
 
 report_mouse_t adns9800_get_report_driver(report_mouse_t mouse_report) {
     report_adns9800_t sensor_report = adns9800_get_report();
+    static int16_t    pending_x = 0, pending_y = 0;
 
-    int8_t clamped_x = constrain_hid(sensor_report.x);
-    int8_t clamped_y = constrain_hid(sensor_report.y);
-
-    mouse_report.x = clamped_x;
-    mouse_report.y = clamped_y;
+    mouse_report.x = constrain_hid_carry(&pending_x, sensor_report.x);
+    mouse_report.y = constrain_hid_carry(&pending_y, sensor_report.y);
 
     return mouse_report;
 }
@@ -117,14 +135,14 @@ const pointing_device_driver_t pointing_device_driver = {
 report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
     pinnacle_data_t touchData = cirque_pinnacle_read_data();
     static uint16_t x = 0, y = 0, mouse_timer = 0;
-    int8_t          report_x = 0, report_y = 0;
+    int16_t         report_x = 0, report_y = 0;
     static bool     is_z_down = false;
 
     cirque_pinnacle_scale_data(&touchData, cirque_pinnacle_get_scale(), cirque_pinnacle_get_scale()); // Scale coordinates to arbitrary X, Y resolution
 
     if (x && y && touchData.xValue && touchData.yValue) {
-        report_x = (int8_t)(touchData.xValue - x);
-        report_y = (int8_t)(touchData.yValue - y);
+        report_x = (int16_t)(touchData.xValue - x);
+        report_y = (int16_t)(touchData.yValue - y);
     }
     x = touchData.xValue;
     y = touchData.yValue;
@@ -149,8 +167,8 @@ report_mouse_t cirque_pinnacle_get_report(report_mouse_t mouse_report) {
     if (timer_elapsed(mouse_timer) > (CIRQUE_PINNACLE_TOUCH_DEBOUNCE)) {
         mouse_timer = 0;
     }
-    mouse_report.x = report_x;
-    mouse_report.y = report_y;
+    mouse_report.x = constrain_hid(report_x);
+    mouse_report.y = constrain_hid(report_y);
 
     return mouse_report;
 }
@@ -182,8 +200,12 @@ report_mouse_t pimoroni_trackball_get_report(report_mouse_t mouse_report) {
                 if (!debounce) {
                     x_offset += pimoroni_trackball_get_offsets(pimoroni_data.right, pimoroni_data.left, PIMORONI_TRACKBALL_SCALE);
                     y_offset += pimoroni_trackball_get_offsets(pimoroni_data.down, pimoroni_data.up, PIMORONI_TRACKBALL_SCALE);
-                    pimoroni_trackball_adapt_values(&mouse_report.x, &x_offset);
-                    pimoroni_trackball_adapt_values(&mouse_report.y, &y_offset);
+                    // the report is packed, so its wider axes cannot be adapted in place
+                    mouse_xy_report_t x, y;
+                    pimoroni_trackball_adapt_values(&x, &x_offset);
+                    pimoroni_trackball_adapt_values(&y, &y_offset);
+                    mouse_report.x = x;
+                    mouse_report.y = y;
                 } else {
                     debounce--;
                 }
@@ -211,9 +233,43 @@ static void pmw3360_device_init(void) {
     pmw3360_init();
 }
 
+#    ifdef PMW3360_MOTION_INTERRUPT
+report_mouse_t pmw3360_get_report(report_mouse_t mouse_report) {
+    // Accumulate everything sampled since the last report
+    static int16_t   pending_x = 0, pending_y = 0;
+    int32_t          dx = 0, dy = 0;
+    pmw3360_sample_t sample;
+    bool             sampled = false;
+    while (pmw3360_get_sample(&sample)) {
+#        ifdef USB_MOUSE_COALESCE
+        // The report latency histogram counts from when the oldest motion was read
+        if (!sampled) {
+            usb_mouse_set_sample_time(sample.systime);
+        }
+#        endif
+        dx += sample.dx;
+        dy += sample.dy;
+        sampled = true;
+    }
+#        ifdef POINTING_DEVICE_ACCEL_ENABLE
+    // Speed is measured between the samples rather than when the main loop gets to them
+    if (sampled) {
+        pointing_device_accel_set_sample_time(sample.time);
+    }
+#        else
+    (void)sampled;
+#        endif
+
+    mouse_report.x = constrain_hid_carry(&pending_x, dx);
+    mouse_report.y = constrain_hid_carry(&pending_y, dy);
+    return mouse_report;
+}
+#    else
 report_mouse_t pmw3360_get_report(report_mouse_t mouse_report) {
     report_pmw3360_t data        = pmw3360_read_burst();
     static uint16_t  MotionStart = 0; // Timer for accel, 0 is resting state
+    static int16_t   pending_x = 0, pending_y = 0;
+    int16_t          dx = 0, dy = 0;
 
     if (data.isOnSurface && data.isMotion) {
         // Reset timer if stopped moving
@@ -229,12 +285,15 @@ report_mouse_t pmw3360_get_report(report_mouse_t mouse_report) {
 #    endif
             MotionStart = timer_read();
         }
-        mouse_report.x = constrain_hid(data.dx);
-        mouse_report.y = constrain_hid(data.dy);
+        dx = data.dx;
+        dy = data.dy;
     }
 
+    mouse_report.x = constrain_hid_carry(&pending_x, dx);
+    mouse_report.y = constrain_hid_carry(&pending_y, dy);
     return mouse_report;
 }
+#    endif
 
 // clang-format off
 const pointing_device_driver_t pointing_device_driver = {
@@ -252,6 +311,8 @@ static void pmw3389_device_init(void) {
 report_mouse_t pmw3389_get_report(report_mouse_t mouse_report) {
     report_pmw3389_t data        = pmw3389_read_burst();
     static uint16_t  MotionStart = 0; // Timer for accel, 0 is resting state
+    static int16_t   pending_x = 0, pending_y = 0;
+    int16_t          dx = 0, dy = 0;
 
     if (data.isOnSurface && data.isMotion) {
         // Reset timer if stopped moving
@@ -267,10 +328,12 @@ report_mouse_t pmw3389_get_report(report_mouse_t mouse_report) {
 #    endif
             MotionStart = timer_read();
         }
-        mouse_report.x = constrain_hid(data.dx);
-        mouse_report.y = constrain_hid(data.dy);
+        dx = data.dx;
+        dy = data.dy;
     }
 
+    mouse_report.x = constrain_hid_carry(&pending_x, dx);
+    mouse_report.y = constrain_hid_carry(&pending_y, dy);
     return mouse_report;
 }
 
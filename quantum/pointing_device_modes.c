@@ -0,0 +1,161 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include "pointing_device_modes.h"
+#include "quantum.h"
+
+enum caret_directions { CARET_RIGHT, CARET_LEFT, CARET_UP, CARET_DOWN };
+
+static pointing_device_mode_t mode = POINTING_DEVICE_MODE_POINTER;
+
+/* Motion not yet turned into wheel units or taps. In scroll mode it is multiplied by the wheel resolution */
+static int32_t accumulated_x = 0, accumulated_y = 0;
+static uint8_t wheel_multiplier = 1, pan_multiplier = 1;
+
+static uint16_t caret_keycodes[] = {KC_RIGHT, KC_LEFT, KC_UP, KC_DOWN};
+static uint8_t  caret_queue[POINTING_DEVICE_CARET_QUEUE_SIZE];
+static uint8_t  caret_head = 0, caret_count = 0;
+static uint16_t caret_held  = KC_NO;
+static uint16_t caret_timer = 0;
+
+/** \brief Changes what the motion of the pointing device does, dropping motion and taps not sent yet */
+void pointing_device_set_mode(pointing_device_mode_t new_mode) {
+    if (new_mode == mode) {
+        return;
+    }
+    mode          = new_mode;
+    accumulated_x = accumulated_y = 0;
+    caret_count                   = 0;
+}
+
+pointing_device_mode_t pointing_device_get_mode(void) {
+    return mode;
+}
+
+/** \brief Changes the keys tapped in caret mode, for instance to select text or switch tabs */
+void pointing_device_set_caret_keycodes(uint16_t right, uint16_t left, uint16_t up, uint16_t down) {
+    caret_keycodes[CARET_RIGHT] = right;
+    caret_keycodes[CARET_LEFT]  = left;
+    caret_keycodes[CARET_UP]    = up;
+    caret_keycodes[CARET_DOWN]  = down;
+}
+
+/* Adds whole wheel units to a wheel value, keeping what does not make a unit or does not fit the report */
+static int8_t add_wheel_units(int8_t value, int32_t *accumulated) {
+    int32_t total = value + *accumulated / POINTING_DEVICE_SCROLL_DIVISOR;
+    if (total > 127) {
+        total = 127;
+    } else if (total < -127) {
+        total = -127;
+    }
+    *accumulated -= (total - value) * POINTING_DEVICE_SCROLL_DIVISOR;
+    return total;
+}
+
+static void scroll(report_mouse_t *mouse_report) {
+    uint8_t wheel = host_mouse_wheel_multiplier();
+    uint8_t pan   = host_mouse_pan_multiplier();
+    if (wheel != wheel_multiplier || pan != pan_multiplier) {
+        // The host changed the resolution, accumulated motion is in the old one
+        wheel_multiplier = wheel;
+        pan_multiplier   = pan;
+        accumulated_x = accumulated_y = 0;
+    }
+
+#ifdef POINTING_DEVICE_SCROLL_INVERT_X
+    accumulated_x -= (int32_t)mouse_report->x * pan;
+#else
+    accumulated_x += (int32_t)mouse_report->x * pan;
+#endif
+#ifdef POINTING_DEVICE_SCROLL_INVERT_Y
+    accumulated_y += (int32_t)mouse_report->y * wheel;
+#else
+    // Moving up scrolls up, the wheel going positive while y goes negative
+    accumulated_y -= (int32_t)mouse_report->y * wheel;
+#endif
+    mouse_report->h = add_wheel_units(mouse_report->h, &accumulated_x);
+    mouse_report->v = add_wheel_units(mouse_report->v, &accumulated_y);
+    mouse_report->x = 0;
+    mouse_report->y = 0;
+}
+
+static void caret(report_mouse_t *mouse_report) {
+    accumulated_x += mouse_report->x;
+    accumulated_y += mouse_report->y;
+    mouse_report->x = 0;
+    mouse_report->y = 0;
+
+    // Taps follow the dominant axis only, so the caret does not drift sideways
+    bool     horizontal  = labs(accumulated_x) > labs(accumulated_y);
+    int32_t *accumulated = horizontal ? &accumulated_x : &accumulated_y;
+    if (labs(*accumulated) < POINTING_DEVICE_CARET_DIVISOR) {
+        return;
+    }
+    if (horizontal) {
+        accumulated_y = 0;
+    } else {
+        accumulated_x = 0;
+    }
+
+    while (labs(*accumulated) >= POINTING_DEVICE_CARET_DIVISOR) {
+        uint8_t direction;
+        if (*accumulated > 0) {
+            direction = horizontal ? CARET_RIGHT : CARET_DOWN;
+            *accumulated -= POINTING_DEVICE_CARET_DIVISOR;
+        } else {
+            direction = horizontal ? CARET_LEFT : CARET_UP;
+            *accumulated += POINTING_DEVICE_CARET_DIVISOR;
+        }
+        if (caret_count < POINTING_DEVICE_CARET_QUEUE_SIZE) {
+            caret_queue[(caret_head + caret_count) % POINTING_DEVICE_CARET_QUEUE_SIZE] = direction;
+            caret_count++;
+        }
+    }
+}
+
+/** \brief Turns the motion of a report into wheel motion or caret taps, depending on the mode */
+report_mouse_t pointing_device_modes_apply(report_mouse_t mouse_report) {
+    switch (mode) {
+        case POINTING_DEVICE_MODE_SCROLL:
+            scroll(&mouse_report);
+            break;
+        case POINTING_DEVICE_MODE_CARET:
+            caret(&mouse_report);
+            break;
+        default:
+            break;
+    }
+    return mouse_report;
+}
+
+/** \brief Sends the queued caret taps, one key event every POINTING_DEVICE_CARET_INTERVAL_MS at most */
+void pointing_device_modes_task(void) {
+    if ((caret_held == KC_NO && caret_count == 0) || timer_elapsed(caret_timer) < POINTING_DEVICE_CARET_INTERVAL_MS) {
+        return;
+    }
+
+    if (caret_held != KC_NO) {
+        unregister_code16(caret_held);
+        caret_held = KC_NO;
+    } else {
+        caret_held = caret_keycodes[caret_queue[caret_head]];
+        caret_head = (caret_head + 1) % POINTING_DEVICE_CARET_QUEUE_SIZE;
+        caret_count--;
+        register_code16(caret_held);
+    }
+    caret_timer = timer_read();
+}
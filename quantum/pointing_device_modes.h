@@ -0,0 +1,52 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "report.h"
+
+/* Sensor counts per wheel detent in scroll mode */
+#ifndef POINTING_DEVICE_SCROLL_DIVISOR
+#    define POINTING_DEVICE_SCROLL_DIVISOR 32
+#endif
+
+/* Sensor counts per key tap in caret mode */
+#ifndef POINTING_DEVICE_CARET_DIVISOR
+#    define POINTING_DEVICE_CARET_DIVISOR 64
+#endif
+
+/* Time between two key events in caret mode, a tap being a press and a release */
+#ifndef POINTING_DEVICE_CARET_INTERVAL_MS
+#    define POINTING_DEVICE_CARET_INTERVAL_MS 10
+#endif
+
+/* Caret mode taps waiting to be sent, further motion is dropped */
+#ifndef POINTING_DEVICE_CARET_QUEUE_SIZE
+#    define POINTING_DEVICE_CARET_QUEUE_SIZE 8
+#endif
+
+typedef enum {
+    POINTING_DEVICE_MODE_POINTER, // motion moves the pointer
+    POINTING_DEVICE_MODE_SCROLL,  // motion turns the wheels
+    POINTING_DEVICE_MODE_CARET,   // motion taps the caret keys, the arrows by default
+} pointing_device_mode_t;
+
+void                   pointing_device_set_mode(pointing_device_mode_t mode);
+pointing_device_mode_t pointing_device_get_mode(void);
+void                   pointing_device_set_caret_keycodes(uint16_t right, uint16_t left, uint16_t up, uint16_t down);
+report_mouse_t         pointing_device_modes_apply(report_mouse_t mouse_report);
+void                   pointing_device_modes_task(void);
@@ -18,6 +18,9 @@
 #include "process_combo.h"
 #include "action_tapping.h"
 #include "action.h"
+#ifdef COMBO_KEY_INDEX
+#    include <stdlib.h>
+#endif
 
 #ifdef COMBO_COUNT
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT];
@@ -90,6 +93,94 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define COMBO_KEY_POS ((keypos_t){.col = 254, .row = 254})
 
+#ifdef COMBO_KEY_INDEX
+#    ifdef PROTOCOL_CHIBIOS
+#        if CH_CFG_USE_MEMCORE == FALSE
+#            error ChibiOS is configured without a memory allocator. Your keyboard may have set `#define CH_CFG_USE_MEMCORE FALSE`, which is incompatible with COMBO_KEY_INDEX.
+#        endif
+#    endif
+
+/* Every (keycode, combo) pair of key_combos, sorted by keycode, so that a key event only visits the combos using it */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+} combo_key_t;
+static combo_key_t *combo_keys       = NULL;
+static uint16_t     combo_keys_count = 0;
+static bool         combo_index_done = false;
+/* One bit per combo whose state has been touched since clear_combos() last reset it */
+static uint8_t *combo_dirty = NULL;
+
+#    define MARK_COMBO_DIRTY(combo_index)                                   \
+        do {                                                                \
+            if (combo_dirty) {                                              \
+                combo_dirty[(combo_index) / 8] |= 1 << ((combo_index) % 8); \
+            }                                                               \
+        } while (0)
+
+static int combo_key_compare(const void *a, const void *b) {
+    const combo_key_t *key_a = a, *key_b = b;
+    if (key_a->keycode != key_b->keycode) {
+        return key_a->keycode < key_b->keycode ? -1 : 1;
+    }
+    return (int)key_a->combo_index - (int)key_b->combo_index;
+}
+
+/* Builds the keycode index of key_combos. Without enough memory for it, every combo keeps being checked on each key event. */
+static void combo_index_init(void) {
+    combo_index_done = true;
+
+    uint16_t count = 0;
+    for (uint16_t index = 0; index < COMBO_LEN; ++index) {
+        for (const uint16_t *keys = key_combos[index].keys; pgm_read_word(keys) != COMBO_END; ++keys) {
+            count++;
+        }
+    }
+
+    combo_keys  = malloc(count * sizeof(combo_key_t));
+    combo_dirty = calloc((COMBO_LEN + 7) / 8, 1);
+    if (!combo_keys || !combo_dirty) {
+        free(combo_keys);
+        free(combo_dirty);
+        combo_keys  = NULL;
+        combo_dirty = NULL;
+        return;
+    }
+
+    count = 0;
+    for (uint16_t index = 0; index < COMBO_LEN; ++index) {
+        for (const uint16_t *keys = key_combos[index].keys; pgm_read_word(keys) != COMBO_END; ++keys) {
+            combo_keys[count++] = (combo_key_t){.keycode = pgm_read_word(keys), .combo_index = index};
+        }
+    }
+    qsort(combo_keys, count, sizeof(combo_key_t), combo_key_compare);
+
+    // A combo listing the same key twice must only be processed once for it
+    combo_keys_count = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (combo_keys_count == 0 || combo_key_compare(&combo_keys[combo_keys_count - 1], &combo_keys[i]) != 0) {
+            combo_keys[combo_keys_count++] = combo_keys[i];
+        }
+    }
+}
+
+/* Returns the position of the first combo using keycode in combo_keys, or combo_keys_count if there is none */
+static uint16_t combo_index_find(uint16_t keycode) {
+    uint16_t low = 0, high = combo_keys_count;
+    while (low < high) {
+        uint16_t middle = low + (high - low) / 2;
+        if (combo_keys[middle].keycode < keycode) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+#else
+#    define MARK_COMBO_DIRTY(combo_index)
+#endif
+
 #ifndef EXTRA_SHORT_COMBOS
 /* flags are their own elements in combo_t struct. */
 #    define COMBO_ACTIVE(combo) (combo->active)
@@ -195,6 +286,22 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+#ifdef COMBO_KEY_INDEX
+    if (combo_dirty) {
+        // Only the combos touched by key events can need a reset
+        for (uint16_t byte = 0; byte < (COMBO_LEN + 7) / 8; ++byte) {
+            for (uint8_t dirty = combo_dirty[byte]; dirty; dirty &= dirty - 1) {
+                uint8_t  bit   = __builtin_ctz(dirty);
+                combo_t *combo = &key_combos[byte * 8 + bit];
+                if (!COMBO_ACTIVE(combo)) {
+                    RESET_COMBO_STATE(combo);
+                    combo_dirty[byte] &= ~(1 << bit);
+                }
+            }
+        }
+        return;
+    }
+#endif
     for (index = 0; index < COMBO_LEN; ++index) {
         combo_t *combo = &key_combos[index];
         if (!COMBO_ACTIVE(combo)) {
@@ -414,6 +521,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     if (-1 == (int16_t)key_index) {
         return false;
     }
+    MARK_COMBO_DIRTY(combo_index);
 
     bool key_is_part_of_combo = (!COMBO_DISABLED(combo) && is_combo_enabled()
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
@@ -549,10 +657,23 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     keycode = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, record->event.key);
 #endif
 
-    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
-        combo_t *combo = &key_combos[idx];
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX
+    if (!combo_index_done) {
+        combo_index_init();
+    }
+    if (combo_keys) {
+        for (uint16_t i = combo_index_find(keycode); i < combo_keys_count && combo_keys[i].keycode == keycode; ++i) {
+            uint16_t idx = combo_keys[i].combo_index;
+            is_combo_key |= process_single_combo(&key_combos[idx], keycode, record, idx);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+            combo_t *combo = &key_combos[idx];
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+            no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
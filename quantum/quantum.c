@@ -36,6 +36,18 @@
 #    include "haptic.h"
 #endif
 
+#ifdef RAW_ENABLE
+#    include "raw_hid.h"
+#endif
+
+#ifdef SCAN_PROFILER_ENABLE
+#    include "scan_profiler.h"
+#endif
+
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -142,6 +154,9 @@ void reset_keyboard(void) {
 #endif
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
+#endif
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_CACHE)
+    dynamic_keymap_flush();
 #endif
     bootloader_jump();
 }
@@ -524,3 +539,24 @@ const char *get_u16_str(uint16_t curr_num, char curr_pad) {
     last_pad = curr_pad;
     return get_numeric_str(buf, sizeof(buf), curr_num, curr_pad);
 }
+
+#if defined(RAW_ENABLE) && !defined(VIA_ENABLE) && (defined(SCAN_PROFILER_ENABLE) || defined(LATENCY_TRACE_ENABLE))
+/** \brief Answers the raw HID requests of the diagnostic features
+ *
+ * Keymaps with their own raw_hid_receive() should forward these requests to the feature handlers.
+ */
+__attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
+#    ifdef SCAN_PROFILER_ENABLE
+    if (scan_profiler_raw_hid_receive(data, length)) {
+        raw_hid_send(data, length);
+        return;
+    }
+#    endif
+#    ifdef LATENCY_TRACE_ENABLE
+    if (latency_trace_raw_hid_receive(data, length)) {
+        raw_hid_send(data, length);
+        return;
+    }
+#    endif
+}
+#endif
@@ -1,5 +1,5 @@
 #ifdef ENABLE_RGB_MATRIX_ALPHAS_MODS
-RGB_MATRIX_EFFECT(ALPHAS_MODS)
+RGB_MATRIX_EFFECT(ALPHAS_MODS, RGB_EFFECT_STATIC)
 #    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 // alphas = color1, mods = color2
@@ -11,8 +11,7 @@ bool ALPHAS_MODS(effect_params_t* params) {
     hsv.h += rgb_matrix_config.speed;
     RGB rgb2 = rgb_matrix_hsv_to_rgb(hsv);
 
-    for (uint8_t i = led_min; i < led_max; i++) {
-        RGB_MATRIX_TEST_LED_FLAGS();
+    RGB_MATRIX_FOREACH_LED(i, led_min, led_max) {
         if (HAS_FLAGS(g_led_config.flags[i], LED_FLAG_MODIFIER)) {
             rgb_matrix_set_color(i, rgb2.r, rgb2.g, rgb2.b);
         } else {
@@ -1,5 +1,5 @@
 #ifdef ENABLE_RGB_MATRIX_GRADIENT_UP_DOWN
-RGB_MATRIX_EFFECT(GRADIENT_UP_DOWN)
+RGB_MATRIX_EFFECT(GRADIENT_UP_DOWN, RGB_EFFECT_STATIC)
 #    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 bool GRADIENT_UP_DOWN(effect_params_t* params) {
@@ -7,8 +7,7 @@ bool GRADIENT_UP_DOWN(effect_params_t* params) {
 
     HSV     hsv   = rgb_matrix_config.hsv;
     uint8_t scale = scale8(64, rgb_matrix_config.speed);
-    for (uint8_t i = led_min; i < led_max; i++) {
-        RGB_MATRIX_TEST_LED_FLAGS();
+    RGB_MATRIX_FOREACH_LED(i, led_min, led_max) {
         // The y range will be 0..64, map this to 0..4
         // Relies on hue being 8-bit and wrapping
         hsv.h   = rgb_matrix_config.hsv.h + scale * (g_led_config.point[i].y >> 4);
@@ -5,14 +5,18 @@ typedef HSV (*dx_dy_dist_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint8
 bool effect_runner_dx_dy_dist(effect_params_t* params, dx_dy_dist_f effect_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint8_t time = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 2);
-    for (uint8_t i = led_min; i < led_max; i++) {
-        RGB_MATRIX_TEST_LED_FLAGS();
+    uint8_t     time  = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 2);
+    hsv_batch_t batch = {.count = 0};
+    RGB_MATRIX_FOREACH_LED(i, led_min, led_max) {
         int16_t dx   = g_led_config.point[i].x - k_rgb_matrix_center.x;
         int16_t dy   = g_led_config.point[i].y - k_rgb_matrix_center.y;
+#ifdef RGB_MATRIX_LED_CACHE
+        uint8_t dist = g_rgb_led_cache.dist[i];
+#else
         uint8_t dist = sqrt16(dx * dx + dy * dy);
-        RGB     rgb  = rgb_matrix_hsv_to_rgb(effect_func(rgb_matrix_config.hsv, dx, dy, dist, time));
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+#endif
+        hsv_batch_add(&batch, i, effect_func(rgb_matrix_config.hsv, dx, dy, dist, time));
     }
+    hsv_batch_flush(&batch);
     return rgb_matrix_check_finished_leds(led_max);
 }
@@ -5,13 +5,13 @@ typedef HSV (*sin_cos_i_f)(HSV hsv, int8_t sin, int8_t cos, uint8_t i, uint8_t t
 bool effect_runner_sin_cos_i(effect_params_t* params, sin_cos_i_f effect_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint16_t time      = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 4);
-    int8_t   cos_value = cos8(time) - 128;
-    int8_t   sin_value = sin8(time) - 128;
-    for (uint8_t i = led_min; i < led_max; i++) {
-        RGB_MATRIX_TEST_LED_FLAGS();
-        RGB rgb = rgb_matrix_hsv_to_rgb(effect_func(rgb_matrix_config.hsv, cos_value, sin_value, i, time));
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+    uint16_t    time      = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 4);
+    int8_t      cos_value = cos8(time) - 128;
+    int8_t      sin_value = sin8(time) - 128;
+    hsv_batch_t batch     = {.count = 0};
+    RGB_MATRIX_FOREACH_LED(i, led_min, led_max) {
+        hsv_batch_add(&batch, i, effect_func(rgb_matrix_config.hsv, cos_value, sin_value, i, time));
     }
+    hsv_batch_flush(&batch);
     return rgb_matrix_check_finished_leds(led_max);
 }
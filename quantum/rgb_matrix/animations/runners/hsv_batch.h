@@ -0,0 +1,29 @@
+#pragma once
+
+#ifndef RGB_MATRIX_HSV_BATCH_SIZE
+#    define RGB_MATRIX_HSV_BATCH_SIZE 8
+#endif
+
+// Colours produced by a runner, converted to RGB and set a batch at a time
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_HSV_BATCH_SIZE];
+    HSV     hsv[RGB_MATRIX_HSV_BATCH_SIZE];
+} hsv_batch_t;
+
+static void hsv_batch_flush(hsv_batch_t* batch) {
+    RGB rgb[RGB_MATRIX_HSV_BATCH_SIZE];
+    rgb_matrix_hsv_to_rgb_batch(batch->hsv, rgb, batch->count);
+    for (uint8_t j = 0; j < batch->count; j++) {
+        rgb_matrix_set_color(batch->index[j], rgb[j].r, rgb[j].g, rgb[j].b);
+    }
+    batch->count = 0;
+}
+
+static inline void hsv_batch_add(hsv_batch_t* batch, uint8_t index, HSV hsv) {
+    batch->index[batch->count] = index;
+    batch->hsv[batch->count]   = hsv;
+    if (++batch->count == RGB_MATRIX_HSV_BATCH_SIZE) {
+        hsv_batch_flush(batch);
+    }
+}
@@ -1,12 +1,11 @@
-RGB_MATRIX_EFFECT(SOLID_COLOR)
+RGB_MATRIX_EFFECT(SOLID_COLOR, RGB_EFFECT_STATIC)
 #ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 bool SOLID_COLOR(effect_params_t* params) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
     RGB rgb = rgb_matrix_hsv_to_rgb(rgb_matrix_config.hsv);
-    for (uint8_t i = led_min; i < led_max; i++) {
-        RGB_MATRIX_TEST_LED_FLAGS();
+    RGB_MATRIX_FOREACH_LED(i, led_min, led_max) {
         rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
     }
     return rgb_matrix_check_finished_leds(led_max);
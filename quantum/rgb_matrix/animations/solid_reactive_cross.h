@@ -2,11 +2,11 @@
 #    if defined(ENABLE_RGB_MATRIX_SOLID_REACTIVE_CROSS) || defined(ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTICROSS)
 
 #        ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_CROSS
-RGB_MATRIX_EFFECT(SOLID_REACTIVE_CROSS)
+RGB_MATRIX_EFFECT(SOLID_REACTIVE_CROSS, RGB_EFFECT_REACTIVE)
 #        endif
 
 #        ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTICROSS
-RGB_MATRIX_EFFECT(SOLID_REACTIVE_MULTICROSS)
+RGB_MATRIX_EFFECT(SOLID_REACTIVE_MULTICROSS, RGB_EFFECT_REACTIVE)
 #        endif
 
 #        ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -2,11 +2,11 @@
 #    if defined(ENABLE_RGB_MATRIX_SOLID_REACTIVE_NEXUS) || defined(ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS)
 
 #        ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_NEXUS
-RGB_MATRIX_EFFECT(SOLID_REACTIVE_NEXUS)
+RGB_MATRIX_EFFECT(SOLID_REACTIVE_NEXUS, RGB_EFFECT_REACTIVE)
 #        endif
 
 #        ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS
-RGB_MATRIX_EFFECT(SOLID_REACTIVE_MULTINEXUS)
+RGB_MATRIX_EFFECT(SOLID_REACTIVE_MULTINEXUS, RGB_EFFECT_REACTIVE)
 #        endif
 
 #        ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
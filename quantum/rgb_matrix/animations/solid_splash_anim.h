@@ -2,11 +2,11 @@
 #    if defined(ENABLE_RGB_MATRIX_SOLID_SPLASH) || defined(ENABLE_RGB_MATRIX_SOLID_MULTISPLASH)
 
 #        ifdef ENABLE_RGB_MATRIX_SOLID_SPLASH
-RGB_MATRIX_EFFECT(SOLID_SPLASH)
+RGB_MATRIX_EFFECT(SOLID_SPLASH, RGB_EFFECT_REACTIVE)
 #        endif
 
 #        ifdef ENABLE_RGB_MATRIX_SOLID_MULTISPLASH
-RGB_MATRIX_EFFECT(SOLID_MULTISPLASH)
+RGB_MATRIX_EFFECT(SOLID_MULTISPLASH, RGB_EFFECT_REACTIVE)
 #        endif
 
 #        ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
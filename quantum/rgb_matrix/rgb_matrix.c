@@ -31,16 +31,28 @@ const led_point_t k_rgb_matrix_center = {112, 32};
 const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
-__attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
+static RGB rgb_matrix_hsv_to_rgb_default(HSV hsv) {
     return hsv_to_rgb(hsv);
 }
+RGB rgb_matrix_hsv_to_rgb(HSV hsv) __attribute__((weak, alias("rgb_matrix_hsv_to_rgb_default")));
+
+// Used by the effect runners, falls back to one colour at a time when rgb_matrix_hsv_to_rgb() is overridden
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+    if (rgb_matrix_hsv_to_rgb != rgb_matrix_hsv_to_rgb_default) {
+        for (uint8_t i = 0; i < count; i++) {
+            rgb[i] = rgb_matrix_hsv_to_rgb(hsv[i]);
+        }
+        return;
+    }
+    hsv_to_rgb_batch(hsv, rgb, count);
+}
 
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
 // ------------------------------------------
 // -----Begin rgb effect includes macros-----
-#define RGB_MATRIX_EFFECT(name)
+#define RGB_MATRIX_EFFECT(name, ...)
 #define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 #include "rgb_matrix_effects.inc"
@@ -119,6 +131,9 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_LED_CACHE
+rgb_led_cache_t g_rgb_led_cache;
+#endif // RGB_MATRIX_LED_CACHE
 
 // internals
 static bool            suspend_state     = false;
@@ -129,6 +144,21 @@ static rgb_task_states rgb_task_state    = SYNCING;
 #if RGB_DISABLE_TIMEOUT > 0
 static uint32_t rgb_anykey_timer;
 #endif // RGB_DISABLE_TIMEOUT > 0
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+static uint8_t      rgb_shadow_buffer[DRIVER_LED_TOTAL][3];
+static uint8_t      rgb_dirty_first    = 0;
+static uint8_t      rgb_dirty_last     = DRIVER_LED_TOTAL - 1;
+static bool         rgb_effect_drawing = false;
+static bool         rgb_overlay_drawn  = false;
+static bool         rgb_effect_skipped = false;
+static rgb_config_t rgb_last_config;
+#    ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+static bool rgb_last_hits = false;
+#    endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+#endif     // RGB_MATRIX_DIRTY_TRACKING
+#ifdef RGB_MATRIX_LED_CACHE
+static bool rgb_led_cache_valid = false;
+#endif // RGB_MATRIX_LED_CACHE
 
 // double buffers
 static uint32_t rgb_timer_buffer;
@@ -140,6 +170,13 @@ static last_hit_t last_hit_buffer;
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
 #endif
+#ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+#    ifndef RGB_MATRIX_SPLIT
+#        error "SPLIT_RGB_MATRIX_HITS_ENABLE requires RGB_MATRIX_SPLIT"
+#    endif
+static rgb_key_hits_t rgb_local_hits;
+static uint8_t        rgb_remote_tail = 0;
+#endif // SPLIT_RGB_MATRIX_HITS_ENABLE
 
 EECONFIG_DEBOUNCE_HELPER(rgb_matrix, EECONFIG_RGB_MATRIX, rgb_matrix_config);
 
@@ -193,15 +230,39 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
 }
 
 void rgb_matrix_update_pwm_buffers(void) {
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    if (rgb_dirty_first > rgb_dirty_last) return;
+
+    if (rgb_matrix_driver.flush_range) {
+        rgb_matrix_driver.flush_range(rgb_dirty_first, rgb_dirty_last);
+    } else {
+        rgb_matrix_driver.flush();
+    }
+    rgb_dirty_first = UINT8_MAX;
+    rgb_dirty_last  = 0;
+#else
     rgb_matrix_driver.flush();
+#endif
 }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    if (index < 0 || index >= DRIVER_LED_TOTAL) return;
+    if (!rgb_effect_drawing) rgb_overlay_drawn = true;
+
+    uint8_t *shadow = rgb_shadow_buffer[index];
+    if (shadow[0] == red && shadow[1] == green && shadow[2] == blue) return;
+    shadow[0] = red;
+    shadow[1] = green;
+    shadow[2] = blue;
+    if (index < rgb_dirty_first) rgb_dirty_first = index;
+    if (index > rgb_dirty_last) rgb_dirty_last = index;
+#endif
     rgb_matrix_driver.set_color(index, red, green, blue);
 }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
-#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+#if (defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)) || defined(RGB_MATRIX_DIRTY_TRACKING)
     for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++)
         rgb_matrix_set_color(i, red, green, blue);
 #else
@@ -209,10 +270,7 @@ void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
 #endif
 }
 
-void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
-#ifndef RGB_MATRIX_SPLIT
-    if (!is_keyboard_master()) return;
-#endif
+static void rgb_matrix_record_hit(uint8_t row, uint8_t col, bool pressed, uint16_t age) {
 #if RGB_DISABLE_TIMEOUT > 0
     rgb_anykey_timer = 0;
 #endif // RGB_DISABLE_TIMEOUT > 0
@@ -243,7 +301,7 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
         last_hit_buffer.x[index]     = g_led_config.point[led[i]].x;
         last_hit_buffer.y[index]     = g_led_config.point[led[i]].y;
         last_hit_buffer.index[index] = led[i];
-        last_hit_buffer.tick[index]  = 0;
+        last_hit_buffer.tick[index]  = age;
         last_hit_buffer.count++;
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -255,6 +313,49 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #endif // defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
 }
 
+void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
+#ifndef RGB_MATRIX_SPLIT
+    if (!is_keyboard_master()) return;
+#endif
+#ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+    // Keys of the other half are replayed from its own hits, see rgb_matrix_receive_split_hits()
+    if (is_keyboard_left() != (row < MATRIX_ROWS / 2)) return;
+
+    rgb_key_hit_t *hit = &rgb_local_hits.hits[rgb_local_hits.head % SPLIT_RGB_MATRIX_HITS_SIZE];
+    hit->row           = row;
+    hit->col           = col;
+    hit->pressed       = pressed;
+    hit->time          = sync_timer_read();
+    rgb_local_hits.head++;
+#endif // SPLIT_RGB_MATRIX_HITS_ENABLE
+    rgb_matrix_record_hit(row, col, pressed, 0);
+}
+
+#ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+/** \brief Copies the latest key hits of this half, for the other half */
+void rgb_matrix_get_split_hits(rgb_key_hits_t *hits) {
+    memcpy(hits, &rgb_local_hits, sizeof(rgb_key_hits_t));
+}
+
+/** \brief Replays the key hits of the other half that were not seen yet
+ *
+ * Hits are aged from the time they happened, so that reactive effects line up on both halves. If more hits than fit
+ * were missed, e.g. after the other half restarted, they are dropped.
+ */
+void rgb_matrix_receive_split_hits(const rgb_key_hits_t *hits) {
+    if ((uint8_t)(hits->head - rgb_remote_tail) > SPLIT_RGB_MATRIX_HITS_SIZE) {
+        rgb_remote_tail = hits->head;
+    }
+
+    uint16_t now = sync_timer_read();
+    for (; rgb_remote_tail != hits->head; rgb_remote_tail++) {
+        const rgb_key_hit_t *hit = &hits->hits[rgb_remote_tail % SPLIT_RGB_MATRIX_HITS_SIZE];
+        int16_t              age = now - hit->time;
+        rgb_matrix_record_hit(hit->row, hit->col, hit->pressed, age > 0 ? age : 0);
+    }
+}
+#endif // SPLIT_RGB_MATRIX_HITS_ENABLE
+
 void rgb_matrix_test(void) {
     // Mask out bits 4 and 5
     // Increase the factor to make the test animation slower (and reduce to make it faster)
@@ -317,7 +418,12 @@ static void rgb_task_timers(void) {
 static void rgb_task_sync(void) {
     eeconfig_flush_rgb_matrix(false);
     // next task
+#if defined(SPLIT_RGB_MATRIX_HITS_ENABLE) && RGB_MATRIX_LED_FLUSH_LIMIT > 0
+    // Start frames on the same sync_timer boundaries on both halves
+    if (sync_timer_read32() / RGB_MATRIX_LED_FLUSH_LIMIT != g_rgb_timer / RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
+#else
     if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
+#endif
 }
 
 static void rgb_task_start(void) {
@@ -334,13 +440,132 @@ static void rgb_task_start(void) {
     rgb_task_state = RENDERING;
 }
 
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+static rgb_effect_class_t rgb_matrix_effect_class(uint8_t effect) {
+    switch (effect) {
+// Picks the optional class argument of RGB_MATRIX_EFFECT(), if given
+#    define RGB_MATRIX_EFFECT_CLASS(name, class, ...) class
+#    define RGB_MATRIX_EFFECT(name, ...) \
+        case RGB_MATRIX_##name:          \
+            return RGB_MATRIX_EFFECT_CLASS(name, ##__VA_ARGS__, RGB_EFFECT_ANIMATED);
+#    include "rgb_matrix_effects.inc"
+#    undef RGB_MATRIX_EFFECT
+
+#    if defined(RGB_MATRIX_CUSTOM_KB) || defined(RGB_MATRIX_CUSTOM_USER)
+#        define RGB_MATRIX_EFFECT(name, ...) \
+            case RGB_MATRIX_CUSTOM_##name:   \
+                return RGB_MATRIX_EFFECT_CLASS(name, ##__VA_ARGS__, RGB_EFFECT_ANIMATED);
+#        ifdef RGB_MATRIX_CUSTOM_KB
+#            include "rgb_matrix_kb.inc"
+#        endif
+#        ifdef RGB_MATRIX_CUSTOM_USER
+#            include "rgb_matrix_user.inc"
+#        endif
+#        undef RGB_MATRIX_EFFECT
+#    endif
+#    undef RGB_MATRIX_EFFECT_CLASS
+
+        default:
+            return RGB_EFFECT_ANIMATED;
+    }
+}
+
+/* Returns true if rendering the effect again would only redraw what is already in the buffer.
+ * Anything drawn outside of the effect, such as indicators, forces the next frame to be rendered
+ * so that it gets painted over once it is no longer drawn.
+ */
+static bool rgb_effect_unchanged(uint8_t effect) {
+    bool unchanged    = !rgb_effect_params.init && !rgb_overlay_drawn && memcmp(&rgb_last_config, &rgb_matrix_config, sizeof(rgb_config_t)) == 0;
+    rgb_last_config   = rgb_matrix_config;
+    rgb_overlay_drawn = false;
+
+    switch (rgb_matrix_effect_class(effect)) {
+        case RGB_EFFECT_STATIC:
+            return unchanged;
+#    ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+        case RGB_EFFECT_REACTIVE: {
+            // render once more after the last hit expired
+            bool hits     = g_last_hit_tracker.count > 0;
+            unchanged     = unchanged && !hits && !rgb_last_hits;
+            rgb_last_hits = hits;
+            return unchanged;
+        }
+#    endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+        default:
+            return false;
+    }
+}
+
+// Steps through the LED ranges like an effect, so that the indicators still cover every LED
+static bool rgb_effect_skip(effect_params_t *params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    (void)led_min;
+    return rgb_matrix_check_finished_leds(led_max);
+}
+#endif // RGB_MATRIX_DIRTY_TRACKING
+
+#ifdef RGB_MATRIX_LED_CACHE
+static void rgb_matrix_update_led_cache(led_flags_t flags) {
+    g_rgb_led_cache.count = 0;
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        if (!HAS_ANY_FLAGS(g_led_config.flags[i], flags)) continue;
+        int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+
+        g_rgb_led_cache.index[g_rgb_led_cache.count++] = i;
+        g_rgb_led_cache.dist[i]                        = sqrt16(dx * dx + dy * dy);
+    }
+    rgb_led_cache_valid = true;
+}
+
+/** \brief Position in g_rgb_led_cache.index of the first cached LED at or after led_min */
+uint8_t rgb_matrix_led_cache_find(uint8_t led_min) {
+    uint8_t low  = 0;
+    uint8_t high = g_rgb_led_cache.count;
+    while (low < high) {
+        uint8_t mid = low + (high - low) / 2;
+        if (g_rgb_led_cache.index[mid] < led_min) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/** \brief Rebuilds the LED cache on the next frame, for code that changes g_led_config at runtime */
+void rgb_matrix_led_cache_invalidate(void) {
+    rgb_led_cache_valid = false;
+}
+#endif // RGB_MATRIX_LED_CACHE
+
 static void rgb_task_render(uint8_t effect) {
     bool rendering         = false;
     rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    if (rgb_effect_params.iter == 0) {
+        rgb_effect_skipped = rgb_effect_unchanged(effect);
+    }
+    if (rgb_effect_skipped) {
+        rendering = rgb_effect_skip(&rgb_effect_params);
+        rgb_effect_params.iter++;
+        if (!rendering) rgb_task_state = FLUSHING;
+        return;
+    }
+    rgb_effect_drawing = true;
+#endif
     if (rgb_effect_params.flags != rgb_matrix_config.flags) {
         rgb_effect_params.flags = rgb_matrix_config.flags;
         rgb_matrix_set_color_all(0, 0, 0);
+#ifdef RGB_MATRIX_LED_CACHE
+        rgb_led_cache_valid = false;
+#endif
     }
+#ifdef RGB_MATRIX_LED_CACHE
+    if (rgb_effect_params.iter == 0 && (rgb_effect_params.init || !rgb_led_cache_valid)) {
+        rgb_matrix_update_led_cache(rgb_effect_params.flags);
+    }
+#endif
 
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
@@ -378,10 +603,16 @@ static void rgb_task_render(uint8_t effect) {
         case UINT8_MAX: {
             rgb_matrix_test();
             rgb_task_state = FLUSHING;
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+            rgb_effect_drawing = false;
+#endif
         }
             return;
     }
 
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    rgb_effect_drawing = false;
+#endif
     rgb_effect_params.iter++;
 
     // next task
@@ -88,6 +88,21 @@
 #define RGB_MATRIX_TEST_LED_FLAGS() \
     if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
 
+#ifdef RGB_MATRIX_LED_CACHE
+#    define RGB_MATRIX_FOREACH_LED(i, min, max) for (uint8_t _n = rgb_matrix_led_cache_find(min), i; _n < g_rgb_led_cache.count && (i = g_rgb_led_cache.index[_n]) < (max); _n++)
+#else
+#    define RGB_MATRIX_FOREACH_LED(i, min, max) \
+        for (uint8_t i = (min); i < (max); i++) \
+            if (HAS_ANY_FLAGS(g_led_config.flags[i], params->flags))
+#endif
+
+/* How the output of an effect changes between frames, optionally declared with RGB_MATRIX_EFFECT(name, class) */
+typedef enum {
+    RGB_EFFECT_ANIMATED, // changes over time, the default
+    RGB_EFFECT_STATIC,   // only depends on rgb_matrix_config
+    RGB_EFFECT_REACTIVE, // only changes while key hits are tracked
+} rgb_effect_class_t;
+
 enum rgb_matrix_effects {
     RGB_MATRIX_NONE = 0,
 
@@ -124,6 +139,11 @@ void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
 
 void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed);
 
+#ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+void rgb_matrix_get_split_hits(rgb_key_hits_t *hits);
+void rgb_matrix_receive_split_hits(const rgb_key_hits_t *hits);
+#endif
+
 void rgb_matrix_task(void);
 
 // This runs after another backlight effect and replaces
@@ -237,6 +257,8 @@ typedef struct {
     void (*set_color_all)(uint8_t r, uint8_t g, uint8_t b);
     /* Flush any buffered changes to the hardware. */
     void (*flush)(void);
+    /* Optional, flush the LEDs between first and last (inclusive) only, when RGB_MATRIX_DIRTY_TRACKING is defined. */
+    void (*flush_range)(uint8_t first, uint8_t last);
 } rgb_matrix_driver_t;
 
 static inline bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
@@ -257,6 +279,20 @@ extern rgb_config_t rgb_matrix_config;
 
 extern uint32_t     g_rgb_timer;
 extern led_config_t g_led_config;
+
+#ifdef RGB_MATRIX_LED_CACHE
+// LEDs matching the flags of the running effect, rebuilt whenever an effect starts or the flags change
+typedef struct {
+    uint8_t count;
+    uint8_t index[DRIVER_LED_TOTAL]; // LED indices, in ascending order
+    uint8_t dist[DRIVER_LED_TOTAL];  // distance of each LED to k_rgb_matrix_center
+} rgb_led_cache_t;
+
+extern rgb_led_cache_t g_rgb_led_cache;
+
+uint8_t rgb_matrix_led_cache_find(uint8_t led_min);
+void    rgb_matrix_led_cache_invalidate(void);
+#endif
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
@@ -345,6 +345,25 @@ static void flush(void) {
     ws2812_setleds(rgb_matrix_ws2812_array, DRIVER_LED_TOTAL);
 }
 
+#    ifdef RGB_MATRIX_DIRTY_TRACKING
+// The LEDs past the last changed one keep their colour, so only the start of the chain needs to be sent
+static void flush_range(uint8_t first, uint8_t last) {
+#        if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+    const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
+    if (!is_keyboard_left()) {
+        if (last < k_rgb_matrix_split[0]) return;
+        last -= k_rgb_matrix_split[0];
+    } else if (first >= k_rgb_matrix_split[0]) {
+        return;
+    } else if (last >= k_rgb_matrix_split[0]) {
+        last = k_rgb_matrix_split[0] - 1;
+    }
+#        endif
+
+    ws2812_setleds(rgb_matrix_ws2812_array, last + 1);
+}
+#    endif
+
 // Set an led in the buffer to a color
 static inline void setled(int i, uint8_t r, uint8_t g, uint8_t b) {
 #    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
@@ -379,5 +398,8 @@ const rgb_matrix_driver_t rgb_matrix_driver = {
     .flush         = flush,
     .set_color     = setled,
     .set_color_all = setled_all,
+#    ifdef RGB_MATRIX_DIRTY_TRACKING
+    .flush_range   = flush_range,
+#    endif
 };
 #endif
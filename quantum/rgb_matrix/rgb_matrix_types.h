@@ -49,6 +49,30 @@ typedef struct PACKED {
 } last_hit_t;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#if defined(RGB_MATRIX_SPLIT) && defined(SPLIT_RGB_MATRIX_HITS_ENABLE)
+#    ifndef SPLIT_RGB_MATRIX_HITS_SIZE
+#        define SPLIT_RGB_MATRIX_HITS_SIZE 8
+#    endif // SPLIT_RGB_MATRIX_HITS_SIZE
+
+#    if (SPLIT_RGB_MATRIX_HITS_SIZE & (SPLIT_RGB_MATRIX_HITS_SIZE - 1)) != 0 || SPLIT_RGB_MATRIX_HITS_SIZE > 128
+#        error "SPLIT_RGB_MATRIX_HITS_SIZE must be a power of two, up to 128"
+#    endif
+
+// Key state change on one half of a split keyboard, replayed by the other half
+typedef struct PACKED {
+    uint8_t  row;
+    uint8_t  col : 7;
+    bool     pressed : 1;
+    uint16_t time; // sync_timer_read() when the key changed state
+} rgb_key_hit_t;
+
+// Latest key hits of one half, as a ring indexed by head
+typedef struct PACKED {
+    uint8_t       head; // number of hits recorded so far, wrapping around
+    rgb_key_hit_t hits[SPLIT_RGB_MATRIX_HITS_SIZE];
+} rgb_key_hits_t;
+#endif // defined(RGB_MATRIX_SPLIT) && defined(SPLIT_RGB_MATRIX_HITS_ENABLE)
+
 typedef enum rgb_task_states { STARTING, RENDERING, FLUSHING, SYNCING } rgb_task_states;
 
 typedef uint8_t led_flags_t;
@@ -0,0 +1,74 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Compares the speed of hsv_to_rgb() and hsv_to_rgb_batch() on the host.
+
+The timings only give an idea of the relative cost of both paths, as the host is nothing like a keyboard MCU.
+*/
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "color.h"
+}
+
+#define FRAME_LEDS 128
+#define FRAMES 20000
+#define BATCH_SIZE 8
+
+TEST(HsvToRgbBatch, Benchmark) {
+    std::mt19937     random(42);
+    std::vector<HSV> frame(FRAME_LEDS);
+    std::vector<RGB> rgb(FRAME_LEDS);
+    unsigned         checksum = 0;
+
+    for (auto& hsv : frame) {
+        hsv = (HSV){(uint8_t)random(), (uint8_t)(128 + random() % 128), (uint8_t)random()};
+    }
+
+    auto time = [&](const char* name, void (*convert)(std::vector<HSV>&, std::vector<RGB>&)) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < FRAMES; i++) {
+            frame[i % FRAME_LEDS].h++;
+            convert(frame, rgb);
+            checksum += rgb[i % FRAME_LEDS].g;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        printf("  %-24s %6.2f ns/LED\n", name, std::chrono::duration<double, std::nano>(elapsed).count() / FRAMES / FRAME_LEDS);
+    };
+
+    printf("hsv_to_rgb, %d LED frame\n", FRAME_LEDS);
+    time("per LED", [](std::vector<HSV>& hsv, std::vector<RGB>& rgb) {
+        for (size_t i = 0; i < hsv.size(); i++) {
+            rgb[i] = hsv_to_rgb(hsv[i]);
+        }
+    });
+    time("batches of 8", [](std::vector<HSV>& hsv, std::vector<RGB>& rgb) {
+        for (size_t i = 0; i < hsv.size(); i += BATCH_SIZE) {
+            hsv_to_rgb_batch(&hsv[i], &rgb[i], BATCH_SIZE);
+        }
+    });
+    time("whole frame", [](std::vector<HSV>& hsv, std::vector<RGB>& rgb) { hsv_to_rgb_batch(hsv.data(), rgb.data(), hsv.size()); });
+
+    // keeps the conversions from being optimised out
+    EXPECT_NE(checksum, 0u);
+}
@@ -0,0 +1,48 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Checks hsv_to_rgb_batch() against hsv_to_rgb() for every HSV colour.
+*/
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "color.h"
+}
+
+TEST(HsvToRgbBatch, MatchesHsvToRgbForEveryColour) {
+    std::vector<HSV> hsv(256 * 256);
+    std::vector<RGB> rgb(hsv.size());
+
+    for (int v = 0; v < 256; v++) {
+        for (int i = 0; i < 256 * 256; i++) {
+            hsv[i] = (HSV){(uint8_t)(i >> 8), (uint8_t)i, (uint8_t)v};
+        }
+        for (size_t i = 0; i < hsv.size(); i += 255) {
+            hsv_to_rgb_batch(&hsv[i], &rgb[i], std::min<size_t>(255, hsv.size() - i));
+        }
+
+        for (size_t i = 0; i < hsv.size(); i++) {
+            RGB expected = hsv_to_rgb(hsv[i]);
+            ASSERT_EQ(rgb[i].r, expected.r) << "h=" << (int)hsv[i].h << " s=" << (int)hsv[i].s << " v=" << v;
+            ASSERT_EQ(rgb[i].g, expected.g) << "h=" << (int)hsv[i].h << " s=" << (int)hsv[i].s << " v=" << v;
+            ASSERT_EQ(rgb[i].b, expected.b) << "h=" << (int)hsv[i].h << " s=" << (int)hsv[i].s << " v=" << v;
+        }
+    }
+}
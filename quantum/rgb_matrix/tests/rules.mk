@@ -0,0 +1,11 @@
+hsv_to_rgb_batch_DEFS := -DUSE_CIE1931_CURVE
+hsv_to_rgb_batch_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/led_tables.c \
+	$(QUANTUM_PATH)/rgb_matrix/tests/hsv_to_rgb_batch_tests.cpp
+
+hsv_to_rgb_batch_benchmark_DEFS := -DUSE_CIE1931_CURVE
+hsv_to_rgb_batch_benchmark_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/led_tables.c \
+	$(QUANTUM_PATH)/rgb_matrix/tests/hsv_to_rgb_batch_benchmark.cpp
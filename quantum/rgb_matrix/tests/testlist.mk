@@ -0,0 +1,4 @@
+TEST_LIST += \
+	hsv_to_rgb_batch
+
+BENCHMARK_LIST += hsv_to_rgb_batch_benchmark
@@ -0,0 +1,292 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "quantum.h"
+#include "scan_profiler.h"
+
+#define SCAN_PROFILER_VERSION 0x01
+
+/* Durations are binned with two buckets per power of two, so p99 is resolved to within 50% */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;    // sum of the last averaged durations, halved with averaged before it overflows
+    uint32_t averaged; // number of durations in total
+    uint16_t buckets[SCAN_PROFILER_BUCKETS];
+} scan_profile_data_t;
+
+static scan_profile_data_t profiles[PROFILE_COUNT];
+
+#ifdef MATRIX_SCAN_THREAD
+/* The scan thread records its own profiles, keep them whole while the main loop reads or resets them */
+#    define SCAN_PROFILER_LOCK() chSysLock()
+#    define SCAN_PROFILER_UNLOCK() chSysUnlock()
+#else
+#    define SCAN_PROFILER_LOCK()
+#    define SCAN_PROFILER_UNLOCK()
+#endif
+
+static const char profile_names[PROFILE_COUNT][SCAN_PROFILER_NAME_LENGTH] PROGMEM = {
+    [PROFILE_KEYBOARD_TASK]   = "keyboard",
+    [PROFILE_MATRIX_SCAN]     = "matrix",
+    [PROFILE_DEBOUNCE]        = "debounce",
+    [PROFILE_SPLIT_TRANSPORT] = "split",
+    [PROFILE_KEY_PROCESSING]  = "keys",
+    [PROFILE_QUANTUM_TASK]    = "quantum",
+    [PROFILE_COMBO]           = "combo",
+    [PROFILE_RGBLIGHT]        = "rgblight",
+    [PROFILE_LED_MATRIX]      = "led_mtx",
+    [PROFILE_RGB_MATRIX]      = "rgb_mtx",
+    [PROFILE_ENCODER]         = "encoder",
+    [PROFILE_OLED]            = "oled",
+    [PROFILE_MOUSEKEY]        = "mousekey",
+    [PROFILE_POINTING_DEVICE] = "pointing",
+};
+
+#if defined(__AVR__)
+#    include <util/atomic.h>
+#    include "timer_avr.h"
+
+#    if defined(__AVR_ATmega32A__)
+#        define TIMER_COMPARE_PENDING() (TIFR & _BV(OCF0))
+#    elif defined(__AVR_ATtiny85__)
+#        define TIMER_COMPARE_PENDING() (TIFR & _BV(OCF0A))
+#    else
+#        define TIMER_COMPARE_PENDING() (TIFR0 & _BV(OCF0A))
+#    endif
+
+extern volatile uint32_t timer_count;
+
+/* The millisecond timer, refined with the count of timer0 that drives it, so no other timer is taken */
+void scan_profiler_init(void) {
+    scan_profiler_reset();
+}
+
+uint32_t scan_profiler_now(void) {
+    uint32_t ms;
+    uint8_t  raw;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+        if (TIMER_COMPARE_PENDING()) {
+            // timer0 wrapped since interrupts were disabled, its millisecond isn't counted yet
+            ms++;
+            raw = TIMER_RAW;
+        }
+    }
+    return ms * (TIMER_RAW_TOP + 1) + raw;
+}
+
+uint32_t scan_profiler_elapsed(uint32_t start) {
+    return scan_profiler_now() - start;
+}
+
+uint32_t scan_profiler_clock_hz(void) {
+    return (uint32_t)(TIMER_RAW_TOP + 1) * 1000;
+}
+#elif defined(PROTOCOL_CHIBIOS) && defined(DWT_CTRL_CYCCNTENA_Msk)
+/* DWT cycle counter, available on Cortex-M3 and above */
+void scan_profiler_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    scan_profiler_reset();
+}
+
+uint32_t scan_profiler_now(void) {
+    return DWT->CYCCNT;
+}
+
+uint32_t scan_profiler_elapsed(uint32_t start) {
+    return DWT->CYCCNT - start;
+}
+
+uint32_t scan_profiler_clock_hz(void) {
+    return CPU_CLOCK;
+}
+#elif defined(PROTOCOL_CHIBIOS)
+/* No cycle counter (Cortex-M0/M0+), fall back to the system tick */
+void scan_profiler_init(void) {
+    scan_profiler_reset();
+}
+
+uint32_t scan_profiler_now(void) {
+    return chVTGetSystemTimeX();
+}
+
+uint32_t scan_profiler_elapsed(uint32_t start) {
+    return chTimeDiffX((systime_t)start, chVTGetSystemTimeX());
+}
+
+uint32_t scan_profiler_clock_hz(void) {
+    return CH_CFG_ST_FREQUENCY;
+}
+#else
+void scan_profiler_init(void) {
+    scan_profiler_reset();
+}
+
+uint32_t scan_profiler_now(void) {
+    return timer_read32();
+}
+
+uint32_t scan_profiler_elapsed(uint32_t start) {
+    return TIMER_DIFF_32(timer_read32(), start);
+}
+
+uint32_t scan_profiler_clock_hz(void) {
+    return 1000;
+}
+#endif
+
+static uint8_t bucket_index(uint32_t ticks) {
+    if (ticks < 2) {
+        return ticks;
+    }
+    uint8_t bits  = sizeof(unsigned long) * 8 - __builtin_clzl(ticks);
+    uint8_t index = 2 * (bits - 1) + ((ticks >> (bits - 2)) & 1);
+    return index < SCAN_PROFILER_BUCKETS ? index : SCAN_PROFILER_BUCKETS - 1;
+}
+
+static uint32_t bucket_upper_bound(uint8_t index) {
+    if (index < 2) {
+        return index;
+    }
+    uint8_t shift = index / 2 - 1;
+    return ((uint32_t)(2 + (index & 1)) << shift) + ((uint32_t)1 << shift) - 1;
+}
+
+void scan_profiler_reset(void) {
+    SCAN_PROFILER_LOCK();
+    memset(profiles, 0, sizeof(profiles));
+    for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+        profiles[i].min = UINT32_MAX;
+    }
+    SCAN_PROFILER_UNLOCK();
+}
+
+void scan_profiler_record(scan_profile_t profile, uint32_t ticks) {
+    scan_profile_data_t *data = &profiles[profile];
+
+    SCAN_PROFILER_LOCK();
+
+    uint8_t index = bucket_index(ticks);
+    if (data->buckets[index] == UINT16_MAX) {
+        // Halve the histogram rather than saturating it, so it keeps tracking recent behaviour
+        for (uint8_t i = 0; i < SCAN_PROFILER_BUCKETS; i++) {
+            data->buckets[i] /= 2;
+        }
+    }
+    data->buckets[index]++;
+
+    if (data->total > UINT32_MAX - ticks) {
+        // Halve the running total too rather than overflowing it, the average then leans towards recent durations
+        data->total /= 2;
+        data->averaged /= 2;
+    }
+    data->total += ticks;
+    data->averaged++;
+
+    data->count++;
+    if (ticks < data->min) data->min = ticks;
+    if (ticks > data->max) data->max = ticks;
+    SCAN_PROFILER_UNLOCK();
+}
+
+void scan_profiler_get_stats(scan_profile_t profile, scan_profile_stats_t *stats) {
+    scan_profile_data_t data;
+    SCAN_PROFILER_LOCK();
+    data = profiles[profile];
+    SCAN_PROFILER_UNLOCK();
+
+    memset(stats, 0, sizeof(scan_profile_stats_t));
+    if (!data.count) {
+        return;
+    }
+    stats->count = data.count;
+    stats->min   = data.min;
+    stats->max   = data.max;
+    stats->avg   = data.total / data.averaged;
+
+    uint32_t samples = 0;
+    for (uint8_t i = 0; i < SCAN_PROFILER_BUCKETS; i++) {
+        samples += data.buckets[i];
+    }
+    uint32_t threshold = samples - samples / 100;
+    uint32_t seen      = 0;
+    for (uint8_t i = 0; i < SCAN_PROFILER_BUCKETS; i++) {
+        seen += data.buckets[i];
+        if (seen >= threshold) {
+            uint32_t bound = bucket_upper_bound(i);
+            stats->p99     = (i == SCAN_PROFILER_BUCKETS - 1 || bound > data.max) ? data.max : bound;
+            break;
+        }
+    }
+}
+
+static uint8_t *put_uint32(uint8_t *buf, uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        *buf++ = value >> (8 * i);
+    }
+    return buf;
+}
+
+/** \brief Handles a scan profiler request in place
+ *
+ * Returns false if the packet is not addressed to the profiler. Otherwise the reply overwrites the request,
+ * with the command byte set to 0xFF when it could not be handled.
+ */
+bool scan_profiler_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != SCAN_PROFILER_RAW_HID_ID) {
+        return false;
+    }
+
+    uint8_t *reply = &data[2];
+    switch (data[1]) {
+        case id_scan_profiler_get_info: {
+            *reply++ = SCAN_PROFILER_VERSION;
+            *reply++ = PROFILE_COUNT;
+            put_uint32(reply, scan_profiler_clock_hz());
+            break;
+        }
+        case id_scan_profiler_get_stats: {
+            uint8_t index = *reply++;
+            if (index >= PROFILE_COUNT || length < 3 + 5 * 4 + SCAN_PROFILER_NAME_LENGTH) {
+                data[1] = 0xFF;
+                break;
+            }
+            scan_profile_stats_t stats;
+            scan_profiler_get_stats(index, &stats);
+            reply = put_uint32(reply, stats.count);
+            reply = put_uint32(reply, stats.min);
+            reply = put_uint32(reply, stats.avg);
+            reply = put_uint32(reply, stats.max);
+            reply = put_uint32(reply, stats.p99);
+            memcpy_P(reply, profile_names[index], SCAN_PROFILER_NAME_LENGTH);
+            break;
+        }
+        case id_scan_profiler_reset: {
+            scan_profiler_reset();
+            break;
+        }
+        default: {
+            data[1] = 0xFF;
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SCAN_PROFILER_BUCKETS
+#    define SCAN_PROFILER_BUCKETS 24
+#endif
+
+#ifndef SCAN_PROFILER_RAW_HID_ID
+#    define SCAN_PROFILER_RAW_HID_ID 0xF0
+#endif
+
+#define SCAN_PROFILER_NAME_LENGTH 8
+
+/* Subsystems timed by the scan profiler, in the order they are reported */
+typedef enum {
+    PROFILE_KEYBOARD_TASK,
+    PROFILE_MATRIX_SCAN,
+    PROFILE_DEBOUNCE,
+    PROFILE_SPLIT_TRANSPORT,
+    PROFILE_KEY_PROCESSING,
+    PROFILE_QUANTUM_TASK,
+    PROFILE_COMBO,
+    PROFILE_RGBLIGHT,
+    PROFILE_LED_MATRIX,
+    PROFILE_RGB_MATRIX,
+    PROFILE_ENCODER,
+    PROFILE_OLED,
+    PROFILE_MOUSEKEY,
+    PROFILE_POINTING_DEVICE,
+    PROFILE_COUNT
+} scan_profile_t;
+
+/* Summary of the recorded durations of one subsystem, in profiler clock ticks */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+} scan_profile_stats_t;
+
+/* raw HID sub-commands, sent as [SCAN_PROFILER_RAW_HID_ID, command, args...] */
+enum scan_profiler_command_id {
+    id_scan_profiler_get_info  = 0x01, // -> version, profile count, clock rate (Hz, little endian)
+    id_scan_profiler_get_stats = 0x02, // index -> count, min, avg, max, p99 (little endian), name
+    id_scan_profiler_reset     = 0x03,
+};
+
+uint32_t scan_profiler_now(void);
+uint32_t scan_profiler_elapsed(uint32_t start);
+uint32_t scan_profiler_clock_hz(void);
+void     scan_profiler_init(void);
+void     scan_profiler_record(scan_profile_t profile, uint32_t ticks);
+void     scan_profiler_reset(void);
+void     scan_profiler_get_stats(scan_profile_t profile, scan_profile_stats_t *stats);
+bool     scan_profiler_raw_hid_receive(uint8_t *data, uint8_t length);
+
+#ifdef SCAN_PROFILER_ENABLE
+/* Times a statement and records its duration against the given profile */
+#    define SCAN_PROFILE(profile, statement)                                          \
+        do {                                                                          \
+            uint32_t scan_profile_start = scan_profiler_now();                        \
+            statement;                                                                \
+            scan_profiler_record(profile, scan_profiler_elapsed(scan_profile_start)); \
+        } while (0)
+#else
+#    define SCAN_PROFILE(profile, statement) \
+        do {                                 \
+            statement;                       \
+        } while (0)
+#endif
@@ -24,6 +24,10 @@ enum serial_transaction_id {
     GET_SLAVE_MATRIX_CHECKSUM,
     GET_SLAVE_MATRIX_DATA,
 
+#ifdef SPLIT_MATRIX_DELTA_SYNC
+    GET_SLAVE_MATRIX_DELTA,
+#endif // SPLIT_MATRIX_DELTA_SYNC
+
 #ifdef SPLIT_TRANSPORT_MIRROR
     PUT_MASTER_MATRIX,
 #endif // SPLIT_TRANSPORT_MIRROR
@@ -64,6 +68,11 @@ enum serial_transaction_id {
 
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
     PUT_RGB_MATRIX,
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+    PUT_RGB_MATRIX_HITS,
+    GET_RGB_MATRIX_HITS_HEAD,
+    GET_RGB_MATRIX_HITS_DATA,
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
 #endif // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
 
 #if defined(WPM_ENABLE) && defined(SPLIT_WPM_ENABLE)
@@ -84,6 +93,11 @@ enum serial_transaction_id {
     PUT_POINTING_CPI,
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_TRANSACTION_BATCH
+    // Must come after all core transactions: everything before it is carried by the batch
+    EXCHANGE_BATCH,
+#endif // SPLIT_TRANSACTION_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
@@ -26,8 +26,6 @@
 #include "split_util.h"
 #include "transaction_id_define.h"
 
-#define SYNC_TIMER_OFFSET 2
-
 #ifndef FORCED_SYNC_THROTTLE_MS
 #    define FORCED_SYNC_THROTTLE_MS 100
 #endif // FORCED_SYNC_THROTTLE_MS
@@ -51,6 +49,19 @@ void slave_rpc_info_callback(uint8_t initiator2target_buffer_size, const void *i
 void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
+#ifdef SPLIT_TRANSACTION_BATCH
+#    ifdef USE_I2C
+#        error "SPLIT_TRANSACTION_BATCH is only supported by the serial transport"
+#    endif // USE_I2C
+// Forward-declare the batch callback handler
+void slave_batch_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+#endif // SPLIT_TRANSACTION_BATCH
+
+#ifdef SPLIT_MATRIX_DELTA_SYNC
+// Forward-declare the slave matrix delta callback handler
+void slave_matrix_delta_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+#endif // SPLIT_MATRIX_DELTA_SYNC
+
 ////////////////////////////////////////////////////
 // Helpers
 
@@ -115,9 +126,189 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
     return send_if_condition(trans_id, last_update, (memcmp(source, equiv_shmem, length) != 0), source, length);
 }
 
+////////////////////////////////////////////////////
+// Batched exchange
+
+#ifdef SPLIT_TRANSACTION_BATCH
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    // Fetches everything read during this scan. Unless SERIAL_USART_ASYNC sends them at the end of the scan, also carries the writes queued during the previous one
+    return transport_batch_exchange();
+}
+
+#    ifdef SERIAL_USART_ASYNC
+static bool batch_start_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    // Sends the writes queued by every other handler, in the background
+    return transport_batch_start();
+}
+
+#        define TRANSACTIONS_BATCH_START_MASTER() TRANSACTION_HANDLER_MASTER(batch_start)
+#    else
+#        define TRANSACTIONS_BATCH_START_MASTER()
+#    endif // SERIAL_USART_ASYNC
+
+// clang-format off
+#    define TRANSACTIONS_BATCH_MASTER() TRANSACTION_HANDLER_MASTER(batch)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+    [EXCHANGE_BATCH] = { sizeof_member(split_shared_memory_t, batch.m2s), offsetof(split_shared_memory_t, batch.m2s), sizeof_member(split_shared_memory_t, batch.s2m), offsetof(split_shared_memory_t, batch.s2m), slave_batch_callback },
+// clang-format on
+
+#else // SPLIT_TRANSACTION_BATCH
+
+#    define TRANSACTIONS_BATCH_MASTER()
+#    define TRANSACTIONS_BATCH_START_MASTER()
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_TRANSACTION_BATCH
+
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#ifdef SPLIT_MATRIX_DELTA_SYNC
+
+_Static_assert((SPLIT_MATRIX_DELTA_LOG_SIZE & (SPLIT_MATRIX_DELTA_LOG_SIZE - 1)) == 0 && SPLIT_MATRIX_DELTA_LOG_SIZE <= 128, "SPLIT_MATRIX_DELTA_LOG_SIZE must be a power of two, no larger than 128");
+
+// Slave side log of the matrix changes, the delta with sequence number n is stored at n % SPLIT_MATRIX_DELTA_LOG_SIZE
+static split_matrix_delta_t matrix_delta_log[SPLIT_MATRIX_DELTA_LOG_SIZE];
+static uint8_t              matrix_delta_seq = 0;
+
+#    ifndef DISABLE_SYNC_TIMER
+// Master side record of when the slave registered the last change of each key
+static uint16_t slave_key_times[(MATRIX_ROWS) / 2][MATRIX_COLS];
+
+uint16_t split_matrix_key_time(uint8_t row, uint8_t col) {
+    // Only the slave's half of the matrix is tracked
+    if ((row < (MATRIX_ROWS) / 2) == isLeftHand) {
+        return 0;
+    }
+    return slave_key_times[row % ((MATRIX_ROWS) / 2)][col];
+}
+#    else
+uint16_t split_matrix_key_time(uint8_t row, uint8_t col) {
+    // Slave timestamps aren't comparable with the master's without the sync timer
+    return 0;
+}
+#    endif // DISABLE_SYNC_TIMER
+
+static bool slave_matrix_resync(matrix_row_t last_matrix[]) {
+    matrix_row_t temp_matrix[(MATRIX_ROWS) / 2];
+    uint8_t      checksum;
+
+    bool okay = transport_read(GET_SLAVE_MATRIX_CHECKSUM, &checksum, sizeof(checksum));
+    okay &= transport_read(GET_SLAVE_MATRIX_DATA, temp_matrix, sizeof(temp_matrix));
+    okay &= checksum == crc8(temp_matrix, sizeof(temp_matrix));
+    if (okay) {
+        memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
+#    ifndef DISABLE_SYNC_TIMER
+        memset(slave_key_times, 0, sizeof(slave_key_times));
+#    endif // DISABLE_SYNC_TIMER
+    }
+    return okay;
+}
+
+static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint8_t      last_seq                       = 0;
+    static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last matrix rebuilt from the slave's deltas
+    split_matrix_delta_reply_t reply;
+
+    bool okay = transport_execute_transaction(GET_SLAVE_MATRIX_DELTA, &last_seq, sizeof(last_seq), &reply, sizeof(reply));
+    okay &= reply.checksum == crc8((uint8_t *)&reply + sizeof(reply.checksum), sizeof(reply) - sizeof(reply.checksum));
+    if (okay) {
+        bool resync = reply.resync || reply.count > SPLIT_MATRIX_DELTA_SIZE;
+        for (uint8_t i = 0; !resync && i < reply.count; ++i) {
+            split_matrix_delta_t *delta = &reply.deltas[i];
+            if (delta->row >= (MATRIX_ROWS) / 2 || delta->col >= MATRIX_COLS) {
+                resync = true;
+                break;
+            }
+            if (delta->pressed) {
+                last_matrix[delta->row] |= (MATRIX_ROW_SHIFTER << delta->col);
+            } else {
+                last_matrix[delta->row] &= ~(MATRIX_ROW_SHIFTER << delta->col);
+            }
+#    ifndef DISABLE_SYNC_TIMER
+            slave_key_times[delta->row][delta->col] = delta->time;
+#    endif // DISABLE_SYNC_TIMER
+        }
+
+        // Once caught up, the rebuilt matrix has to match the slave's
+        if (!resync && !reply.pending) {
+            resync = reply.matrix_checksum != crc8(last_matrix, sizeof(last_matrix));
+        }
+
+        // Deltas are absolute key states, so any that overlap with the full matrix can safely be applied again
+        okay = !resync || slave_matrix_resync(last_matrix);
+        if (okay) {
+            last_seq = reply.seq;
+        }
+    }
+    // Copy out the last-known-good matrix state to the slave matrix
+    memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
+    return okay;
+}
+
+static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    uint16_t time = sync_timer_read() | 1; /* time should not be 0 */
+    for (uint8_t row = 0; row < (MATRIX_ROWS) / 2; ++row) {
+        matrix_row_t change = slave_matrix[row] ^ split_shmem->smatrix.matrix[row];
+        for (uint8_t col = 0; change && col < MATRIX_COLS; ++col) {
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << col;
+            if (change & col_mask) {
+                // The entry is written before its sequence number is published, so the transaction callback never
+                // sends a slot that is not filled in yet
+                uint8_t seq                                         = matrix_delta_seq + 1;
+                matrix_delta_log[seq % SPLIT_MATRIX_DELTA_LOG_SIZE] = (split_matrix_delta_t){.row = row, .pressed = (slave_matrix[row] & col_mask) != 0, .col = col, .time = time};
+                __atomic_store_n(&matrix_delta_seq, seq, __ATOMIC_RELEASE);
+                change &= ~col_mask;
+            }
+        }
+    }
+
+    memcpy(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix));
+    split_shmem->smatrix.checksum = crc8(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+}
+
+void slave_matrix_delta_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    split_slave_matrix_delta_sync_t *sync  = &split_shmem->smatrix_delta;
+    split_matrix_delta_reply_t *     reply = &sync->reply;
+    uint8_t                          behind = __atomic_load_n(&matrix_delta_seq, __ATOMIC_ACQUIRE) - sync->ack;
+
+    memset(reply, 0, sizeof(*reply));
+    if (behind > SPLIT_MATRIX_DELTA_LOG_SIZE) {
+        // The master missed deltas that have since been overwritten
+        reply->resync = true;
+        reply->seq    = matrix_delta_seq;
+    } else {
+        reply->count = behind < SPLIT_MATRIX_DELTA_SIZE ? behind : SPLIT_MATRIX_DELTA_SIZE;
+        for (uint8_t i = 0; i < reply->count; ++i) {
+            reply->deltas[i] = matrix_delta_log[(uint8_t)(sync->ack + 1 + i) % SPLIT_MATRIX_DELTA_LOG_SIZE];
+        }
+        reply->seq     = sync->ack + reply->count;
+        reply->pending = behind - reply->count;
+
+        // Deltas logged while copying may have overwritten the oldest of the copied slots
+        uint8_t seq = __atomic_load_n(&matrix_delta_seq, __ATOMIC_ACQUIRE);
+        if ((uint8_t)(seq - sync->ack) > SPLIT_MATRIX_DELTA_LOG_SIZE) {
+            memset(reply, 0, sizeof(*reply));
+            reply->resync = true;
+            reply->seq    = seq;
+        }
+    }
+    reply->matrix_checksum = split_shmem->smatrix.checksum;
+    reply->checksum        = crc8((uint8_t *)reply + sizeof(reply->checksum), sizeof(*reply) - sizeof(reply->checksum));
+}
+
+// clang-format off
+#    define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+    [GET_SLAVE_MATRIX_CHECKSUM] = trans_target2initiator_initializer(smatrix.checksum), \
+    [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix), \
+    [GET_SLAVE_MATRIX_DELTA]    = { sizeof_member(split_shared_memory_t, smatrix_delta.ack), offsetof(split_shared_memory_t, smatrix_delta.ack), sizeof_member(split_shared_memory_t, smatrix_delta.reply), offsetof(split_shared_memory_t, smatrix_delta.reply), slave_matrix_delta_callback },
+// clang-format on
+
+#else // SPLIT_MATRIX_DELTA_SYNC
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
@@ -139,13 +330,15 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
 }
 
 // clang-format off
-#define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+#    define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
     [GET_SLAVE_MATRIX_CHECKSUM] = trans_target2initiator_initializer(smatrix.checksum), \
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+#endif // SPLIT_MATRIX_DELTA_SYNC
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -472,22 +665,64 @@ static void led_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+static bool rgb_matrix_hits_exchange(void) {
+    static uint32_t last_update = 0;
+    static uint8_t  slave_head  = 0;
+
+    // Only fetch the slave's hits once it recorded new ones
+    uint8_t head;
+    bool    okay = transport_read(GET_RGB_MATRIX_HITS_HEAD, &head, sizeof(head));
+    if (okay && head != slave_head) {
+        rgb_key_hits_t slave_hits;
+        okay = transport_read(GET_RGB_MATRIX_HITS_DATA, &slave_hits, sizeof(slave_hits));
+        if (okay) {
+            rgb_matrix_receive_split_hits(&slave_hits);
+            slave_head = slave_hits.head;
+        }
+    }
+
+    rgb_key_hits_t master_hits;
+    rgb_matrix_get_split_hits(&master_hits);
+    okay &= send_if_data_mismatch(PUT_RGB_MATRIX_HITS, &last_update, &master_hits, &split_shmem->rgb_matrix_hits.master, sizeof(master_hits));
+    return okay;
+}
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
+
 static bool rgb_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t   last_update = 0;
     rgb_matrix_sync_t rgb_matrix_sync;
     memcpy(&rgb_matrix_sync.rgb_matrix, &rgb_matrix_config, sizeof(rgb_config_t));
     rgb_matrix_sync.rgb_suspend_state = rgb_matrix_get_suspend_state();
-    return send_if_data_mismatch(PUT_RGB_MATRIX, &last_update, &rgb_matrix_sync, &split_shmem->rgb_matrix_sync, sizeof(rgb_matrix_sync));
+    bool okay                         = send_if_data_mismatch(PUT_RGB_MATRIX, &last_update, &rgb_matrix_sync, &split_shmem->rgb_matrix_sync, sizeof(rgb_matrix_sync));
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+    okay &= rgb_matrix_hits_exchange();
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
+    return okay;
 }
 
 static void rgb_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     memcpy(&rgb_matrix_config, &split_shmem->rgb_matrix_sync.rgb_matrix, sizeof(rgb_config_t));
     rgb_matrix_set_suspend_state(split_shmem->rgb_matrix_sync.rgb_suspend_state);
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+    rgb_matrix_get_split_hits(&split_shmem->rgb_matrix_hits.slave);
+    rgb_matrix_receive_split_hits(&split_shmem->rgb_matrix_hits.master);
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
 }
 
+// clang-format off
 #    define TRANSACTIONS_RGB_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(rgb_matrix)
 #    define TRANSACTIONS_RGB_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(rgb_matrix)
-#    define TRANSACTIONS_RGB_MATRIX_REGISTRATIONS [PUT_RGB_MATRIX] = trans_initiator2target_initializer(rgb_matrix_sync),
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+#        define TRANSACTIONS_RGB_MATRIX_REGISTRATIONS \
+    [PUT_RGB_MATRIX]           = trans_initiator2target_initializer(rgb_matrix_sync), \
+    [PUT_RGB_MATRIX_HITS]      = trans_initiator2target_initializer(rgb_matrix_hits.master), \
+    [GET_RGB_MATRIX_HITS_HEAD] = trans_target2initiator_initializer(rgb_matrix_hits.slave.head), \
+    [GET_RGB_MATRIX_HITS_DATA] = trans_target2initiator_initializer(rgb_matrix_hits.slave),
+#    else
+#        define TRANSACTIONS_RGB_MATRIX_REGISTRATIONS [PUT_RGB_MATRIX] = trans_initiator2target_initializer(rgb_matrix_sync),
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
+// clang-format on
 
 #else // defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 
@@ -675,6 +910,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif // USE_I2C
 
     // clang-format off
+    TRANSACTIONS_BATCH_REGISTRATIONS
     TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS
     TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS
     TRANSACTIONS_ENCODERS_REGISTRATIONS
@@ -701,6 +937,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRANSACTIONS_BATCH_MASTER();
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -716,6 +953,7 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_OLED_MASTER();
     TRANSACTIONS_ST7565_MASTER();
     TRANSACTIONS_POINTING_MASTER();
+    TRANSACTIONS_BATCH_START_MASTER();
     return true;
 }
 
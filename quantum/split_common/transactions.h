@@ -51,3 +51,8 @@ bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer
 
 #define transaction_rpc_send(transaction_id, initiator2target_buffer_size, initiator2target_buffer) transaction_rpc_exec(transaction_id, initiator2target_buffer_size, initiator2target_buffer, 0, NULL)
 #define transaction_rpc_recv(transaction_id, target2initiator_buffer_size, target2initiator_buffer) transaction_rpc_exec(transaction_id, 0, NULL, target2initiator_buffer_size, target2initiator_buffer)
+
+#ifdef SPLIT_MATRIX_DELTA_SYNC
+// returns the time the slave registered the last change of the given key, or 0 if unknown
+uint16_t split_matrix_key_time(uint8_t row, uint8_t col);
+#endif // SPLIT_MATRIX_DELTA_SYNC
@@ -100,7 +100,7 @@ void transport_slave_init(void) {
     soft_serial_target_init();
 }
 
-bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+static bool transport_serial_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
     split_transaction_desc_t *trans = &split_transaction_table[id];
     if (initiator2target_length > 0) {
         size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
@@ -119,6 +119,206 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
     return true;
 }
 
+#    ifdef SPLIT_TRANSACTION_BATCH
+
+#        include "crc.h"
+#        include "sync_timer.h"
+
+// Transaction buffer sizes are limited to uint8_t
+_Static_assert(sizeof(shared_memory.batch.m2s) <= UINT8_MAX, "SPLIT_TRANSACTION_BATCH_M2S_SIZE is too large");
+_Static_assert(sizeof(shared_memory.batch.s2m) <= UINT8_MAX, "SPLIT_TRANSACTION_BATCH_S2M_SIZE is too large");
+_Static_assert(EXCHANGE_BATCH <= 32, "Too many transactions for SPLIT_TRANSACTION_BATCH");
+
+static uint32_t batch_pending  = 0; // master to slave transactions waiting for the next exchange
+static uint32_t batch_received = 0; // slave to master transactions carried by the last exchange
+
+static inline uint8_t batch_region_size(int8_t id, bool target2initiator) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    return target2initiator ? trans->target2initiator_buffer_size : trans->initiator2target_buffer_size;
+}
+
+static inline uint8_t *batch_region(int8_t id, bool target2initiator) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    return target2initiator ? split_trans_target2initiator_buffer(trans) : split_trans_initiator2target_buffer(trans);
+}
+
+// Packs as many of the requested transactions as fit into the frame, and returns its checksum
+static uint8_t batch_pack(uint32_t requested, bool target2initiator, uint8_t *frame, size_t frame_size) {
+    uint32_t included = 0;
+    size_t   used     = sizeof(included);
+    for (int8_t id = 0; id < EXCHANGE_BATCH; ++id) {
+        uint8_t size = batch_region_size(id, target2initiator);
+        if (!(requested & (1UL << id)) || size == 0 || split_transaction_table[id].slave_callback || used + size > frame_size) {
+            continue;
+        }
+        memcpy(frame + used, batch_region(id, target2initiator), size);
+        used += size;
+        included |= (1UL << id);
+    }
+    memcpy(frame, &included, sizeof(included));
+    return crc8(frame, used);
+}
+
+// Verifies the frame against its checksum and copies its contents out to the shared memory regions
+static bool batch_unpack(bool target2initiator, const uint8_t *frame, size_t frame_size, uint8_t checksum, uint32_t *included) {
+    size_t used = sizeof(*included);
+    memcpy(included, frame, sizeof(*included));
+    for (int8_t id = 0; id < EXCHANGE_BATCH; ++id) {
+        if (*included & (1UL << id)) {
+            used += batch_region_size(id, target2initiator);
+        }
+    }
+    if ((*included & ~(uint32_t)((1ULL << EXCHANGE_BATCH) - 1)) || used > frame_size || crc8(frame, used) != checksum) {
+        return false;
+    }
+
+    used = sizeof(*included);
+    for (int8_t id = 0; id < EXCHANGE_BATCH; ++id) {
+        if (*included & (1UL << id)) {
+            uint8_t size = batch_region_size(id, target2initiator);
+            memcpy(batch_region(id, target2initiator), frame + used, size);
+            used += size;
+        }
+    }
+    return true;
+}
+
+// Packs the pending writes into the master to slave frame of the next exchange
+static void batch_pack_pending(void) {
+#        ifndef DISABLE_SYNC_TIMER
+    if (batch_pending & (1UL << PUT_SYNC_TIMER)) {
+        // Stamp the timer as it leaves, rather than when it was queued during the previous scan
+        split_shmem->sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
+    }
+#        endif // DISABLE_SYNC_TIMER
+
+    split_batch_sync_t *batch = &split_shmem->batch;
+    batch->m2s.checksum       = batch_pack(batch_pending, false, batch->m2s.frame, sizeof(batch->m2s.frame));
+}
+
+// Sends the pending writes that didn't fit in the frame as individual transactions, so they aren't stuck forever
+static bool batch_send_unpacked(void) {
+    uint32_t packed;
+    memcpy(&packed, split_shmem->batch.m2s.frame, sizeof(packed));
+
+    bool okay = true;
+    for (int8_t id = 0; id < EXCHANGE_BATCH; ++id) {
+        if (!((batch_pending & ~packed) & (1UL << id))) {
+            continue;
+        }
+        if (soft_serial_transaction(id)) {
+            batch_pending &= ~(1UL << id);
+        } else {
+            okay = false;
+        }
+    }
+    return okay;
+}
+
+// Unpacks the slave's reply to the last exchange, and retires the writes it acknowledged
+static bool batch_complete(bool okay) {
+    split_batch_sync_t *batch = &split_shmem->batch;
+
+    uint32_t included = 0;
+    if (!okay || !batch_unpack(true, batch->s2m.frame, sizeof(batch->s2m.frame), batch->s2m.checksum, &included)) {
+        batch_received = 0;
+        return false;
+    }
+    batch_received = included;
+
+    // Keep the writes pending until the slave has acknowledged them
+    if (batch->s2m.ack != batch->m2s.checksum) {
+        return false;
+    }
+    uint32_t sent;
+    memcpy(&sent, batch->m2s.frame, sizeof(sent));
+    batch_pending &= ~sent;
+    return true;
+}
+
+#        ifdef SERIAL_USART_ASYNC
+static bool batch_in_flight = false;
+
+// Waits for the exchange running in the background, if any
+static bool batch_collect(void) {
+    if (!batch_in_flight) {
+        return true;
+    }
+    batch_in_flight = false;
+    return batch_complete(soft_serial_transaction_wait());
+}
+
+bool transport_batch_exchange(void) {
+    // Collect the exchange started at the end of the previous scan, it carries what is read during this one
+    return batch_collect();
+}
+
+bool transport_batch_start(void) {
+    // Waits out an earlier attempt when retried
+    batch_collect();
+
+    // Carry the writes queued during this scan, and leave the exchange running in the background
+    batch_pack_pending();
+    bool okay       = batch_send_unpacked();
+    batch_in_flight = soft_serial_transaction_start(EXCHANGE_BATCH);
+    return okay && batch_in_flight;
+}
+#        else
+#            define batch_collect()
+
+bool transport_batch_exchange(void) {
+    batch_pack_pending();
+    bool okay = batch_complete(soft_serial_transaction(EXCHANGE_BATCH));
+    return batch_send_unpacked() && okay;
+}
+#        endif // SERIAL_USART_ASYNC
+
+void slave_batch_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    split_batch_sync_t *batch = &split_shmem->batch;
+
+    uint32_t included;
+    batch->s2m.ack = batch_unpack(false, batch->m2s.frame, sizeof(batch->m2s.frame), batch->m2s.checksum, &included) ? batch->m2s.checksum : ~batch->m2s.checksum;
+
+    // Reply with the current state of every slave to master transaction
+    batch->s2m.checksum = batch_pack(UINT32_MAX, true, batch->s2m.frame, sizeof(batch->s2m.frame));
+}
+
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    // Keyboard and user transactions, RPC, and anything relying on a slave callback still run as individual transactions
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (id > EXCHANGE_BATCH || trans->slave_callback) {
+        batch_collect();
+        return transport_serial_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+    }
+
+    if (target2initiator_length > 0 && !(batch_received & (1UL << id))) {
+        // Not carried by the last exchange, e.g. didn't fit in the frame
+        batch_collect();
+        return transport_serial_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+    }
+
+    if (initiator2target_length > 0) {
+        size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
+        memcpy(split_trans_initiator2target_buffer(trans), initiator2target_buf, len);
+        batch_pending |= (1UL << id);
+    }
+
+    if (target2initiator_length > 0) {
+        size_t len = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
+        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
+    }
+
+    return true;
+}
+
+#    else // SPLIT_TRANSACTION_BATCH
+
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    return transport_serial_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+}
+
+#    endif // SPLIT_TRANSACTION_BATCH
+
 #endif // USE_I2C
 
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
@@ -23,6 +23,9 @@
 #include "action_layer.h"
 #include "matrix.h"
 
+// Added to the sync timer sent to the slave, to make up for the time it takes to get there
+#define SYNC_TIMER_OFFSET 2
+
 #ifndef RPC_M2S_BUFFER_SIZE
 #    define RPC_M2S_BUFFER_SIZE 32
 #endif // RPC_M2S_BUFFER_SIZE
@@ -58,6 +61,37 @@ typedef struct _split_slave_matrix_sync_t {
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
 } split_slave_matrix_sync_t;
 
+#ifdef SPLIT_MATRIX_DELTA_SYNC
+#    ifndef SPLIT_MATRIX_DELTA_SIZE
+#        define SPLIT_MATRIX_DELTA_SIZE 4
+#    endif // SPLIT_MATRIX_DELTA_SIZE
+#    ifndef SPLIT_MATRIX_DELTA_LOG_SIZE
+#        define SPLIT_MATRIX_DELTA_LOG_SIZE 32
+#    endif // SPLIT_MATRIX_DELTA_LOG_SIZE
+
+typedef struct _split_matrix_delta_t {
+    uint8_t  row : 7;
+    uint8_t  pressed : 1;
+    uint8_t  col;
+    uint16_t time;
+} split_matrix_delta_t;
+
+typedef struct _split_matrix_delta_reply_t {
+    uint8_t              checksum;        // of the rest of the reply
+    uint8_t              matrix_checksum; // of the current slave matrix, see split_slave_matrix_sync_t
+    uint8_t              seq;             // sequence number of the last included delta
+    uint8_t              count;           // number of included deltas
+    uint8_t              pending;         // number of deltas left for the following transactions
+    bool                 resync;          // the deltas following ack are no longer available
+    split_matrix_delta_t deltas[SPLIT_MATRIX_DELTA_SIZE];
+} split_matrix_delta_reply_t;
+
+typedef struct _split_slave_matrix_delta_sync_t {
+    uint8_t                    ack; // sequence number of the last delta applied by the master
+    split_matrix_delta_reply_t reply;
+} split_slave_matrix_delta_sync_t;
+#endif // SPLIT_MATRIX_DELTA_SYNC
+
 #ifdef SPLIT_TRANSPORT_MIRROR
 typedef struct _split_master_matrix_sync_t {
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
@@ -94,6 +128,13 @@ typedef struct _rgb_matrix_sync_t {
     rgb_config_t rgb_matrix;
     bool         rgb_suspend_state;
 } rgb_matrix_sync_t;
+
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+typedef struct _rgb_matrix_hits_sync_t {
+    rgb_key_hits_t master; // key hits of the master half, replayed by the slave
+    rgb_key_hits_t slave;  // key hits of the slave half, replayed by the master
+} rgb_matrix_hits_sync_t;
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
 #endif // defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 
 #ifdef SPLIT_MODS_ENABLE
@@ -115,6 +156,33 @@ typedef struct _split_slave_pointing_sync_t {
 } split_slave_pointing_sync_t;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_TRANSACTION_BATCH
+#    ifndef SPLIT_TRANSACTION_BATCH_M2S_SIZE
+#        define SPLIT_TRANSACTION_BATCH_M2S_SIZE 64
+#    endif // SPLIT_TRANSACTION_BATCH_M2S_SIZE
+#    ifndef SPLIT_TRANSACTION_BATCH_S2M_SIZE
+#        define SPLIT_TRANSACTION_BATCH_S2M_SIZE 32
+#    endif // SPLIT_TRANSACTION_BATCH_S2M_SIZE
+
+// Each frame holds a checksum, followed by a uint32_t bitmask of the included transactions and their packed data
+typedef struct _split_batch_sync_t {
+    struct {
+        uint8_t checksum;
+        uint8_t frame[sizeof(uint32_t) + SPLIT_TRANSACTION_BATCH_M2S_SIZE];
+    } m2s;
+    struct {
+        uint8_t ack; // checksum of the last master to slave frame the slave accepted
+        uint8_t checksum;
+        uint8_t frame[sizeof(uint32_t) + SPLIT_TRANSACTION_BATCH_S2M_SIZE];
+    } s2m;
+} split_batch_sync_t;
+
+bool transport_batch_exchange(void);
+#    ifdef SERIAL_USART_ASYNC
+bool transport_batch_start(void);
+#    endif // SERIAL_USART_ASYNC
+#endif // SPLIT_TRANSACTION_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 typedef struct _rpc_sync_info_t {
     int8_t  transaction_id;
@@ -130,6 +198,10 @@ typedef struct _split_shared_memory_t {
 
     split_slave_matrix_sync_t smatrix;
 
+#ifdef SPLIT_MATRIX_DELTA_SYNC
+    split_slave_matrix_delta_sync_t smatrix_delta;
+#endif // SPLIT_MATRIX_DELTA_SYNC
+
 #ifdef SPLIT_TRANSPORT_MIRROR
     split_master_matrix_sync_t mmatrix;
 #endif // SPLIT_TRANSPORT_MIRROR
@@ -168,6 +240,9 @@ typedef struct _split_shared_memory_t {
 
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
     rgb_matrix_sync_t rgb_matrix_sync;
+#    ifdef SPLIT_RGB_MATRIX_HITS_ENABLE
+    rgb_matrix_hits_sync_t rgb_matrix_hits;
+#    endif // SPLIT_RGB_MATRIX_HITS_ENABLE
 #endif // defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 
 #if defined(WPM_ENABLE) && defined(SPLIT_WPM_ENABLE)
@@ -186,6 +261,10 @@ typedef struct _split_shared_memory_t {
     split_slave_pointing_sync_t pointing;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_TRANSACTION_BATCH
+    split_batch_sync_t batch;
+#endif // SPLIT_TRANSACTION_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
@@ -47,6 +47,12 @@
 #include "eeprom.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
+#ifdef SCAN_PROFILER_ENABLE
+#    include "scan_profiler.h"
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -114,6 +120,10 @@ void eeconfig_init_via(void) {
     dynamic_keymap_reset();
     // This resets the macros in EEPROM to nothing.
     dynamic_keymap_macro_reset();
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    // Make sure the reset has reached EEPROM before marking it valid
+    dynamic_keymap_flush();
+#endif
     // Save the magic number last, in case saving was interrupted
     via_eeprom_set_valid(true);
 }
@@ -377,6 +387,18 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_buffer(offset, size, &command_data[3]);
             break;
         }
+#ifdef SCAN_PROFILER_ENABLE
+        case SCAN_PROFILER_RAW_HID_ID: {
+            scan_profiler_raw_hid_receive(data, length);
+            break;
+        }
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+        case LATENCY_TRACE_RAW_HID_ID: {
+            latency_trace_raw_hid_receive(data, length);
+            break;
+        }
+#endif
         default: {
             // The command ID is not known
             // Return the unhandled state
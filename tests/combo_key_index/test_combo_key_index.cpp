@@ -0,0 +1,167 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "process_combo.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" {
+const uint16_t PROGMEM ab_combo[]  = {KC_A, KC_B, COMBO_END};
+const uint16_t PROGMEM bc_combo[]  = {KC_B, KC_C, COMBO_END};
+const uint16_t PROGMEM abc_combo[] = {KC_A, KC_B, KC_C, COMBO_END};
+const uint16_t PROGMEM de_combo[]  = {KC_D, KC_E, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {
+    COMBO(ab_combo, KC_X),
+    COMBO(bc_combo, KC_Y),
+    COMBO(abc_combo, KC_Z),
+    COMBO(de_combo, KC_W),
+};
+}
+
+class ComboKeyIndex : public TestFixture {};
+
+TEST_F(ComboKeyIndex, ComboFires) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    run_one_scan_loop();
+    key_b.release();
+    run_one_scan_loop();
+}
+
+TEST_F(ComboKeyIndex, KeysOutsideCombosAreNotDelayed) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_g = KeymapKey(0, 0, 0, KC_G);
+    set_keymap({key_g});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_G)));
+    key_g.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_g.release();
+    run_one_scan_loop();
+}
+
+TEST_F(ComboKeyIndex, LongestOverlappingComboWins) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    set_keymap({key_a, key_b, key_c});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    key_c.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+}
+
+TEST_F(ComboKeyIndex, UnfinishedComboSendsItsKeys) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_b});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    key_b.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_b.release();
+    run_one_scan_loop();
+}
+
+TEST_F(ComboKeyIndex, ComboSharingKeysWithOthersFires) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    set_keymap({key_b, key_c});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Y)));
+    key_c.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_b.release();
+    key_c.release();
+    run_one_scan_loop();
+    run_one_scan_loop();
+}
+
+TEST_F(ComboKeyIndex, LastComboInTableFires) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_d = KeymapKey(0, 3, 0, KC_D);
+    auto       key_e = KeymapKey(0, 4, 0, KC_E);
+    set_keymap({key_d, key_e});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_W)));
+    key_e.press();
+    run_one_scan_loop();
+    key_d.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_d.release();
+    key_e.release();
+    run_one_scan_loop();
+    run_one_scan_loop();
+}
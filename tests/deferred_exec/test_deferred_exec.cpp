@@ -0,0 +1,210 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+struct Call {
+    uint32_t trigger_time;
+    int      id;
+};
+
+static std::vector<Call> calls;
+static uint32_t          repeat_delay;
+
+static uint32_t record_call(uint32_t trigger_time, void *cb_arg) {
+    calls.push_back({trigger_time, *(int *)cb_arg});
+    return repeat_delay;
+}
+
+class DeferredExec : public TestFixture {
+   protected:
+    void SetUp() override {
+        calls.clear();
+        repeat_delay = 0;
+        start        = timer_read32();
+    }
+
+    void TearDown() override {
+        for (deferred_token token : tokens) {
+            cancel_deferred_exec(token);
+        }
+    }
+
+    deferred_token defer(uint32_t delay_ms, int *id) {
+        deferred_token token = defer_exec(delay_ms, record_call, id);
+        tokens.push_back(token);
+        return token;
+    }
+
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advance_time(1);
+            deferred_exec_task();
+        }
+    }
+
+    uint32_t                    start;
+    std::vector<deferred_token> tokens;
+};
+
+TEST_F(DeferredExec, CallbackRunsOnceWhenDue) {
+    int id = 1;
+    EXPECT_NE(defer(10, &id), INVALID_DEFERRED_TOKEN);
+
+    run_for(9);
+    EXPECT_TRUE(calls.empty());
+
+    run_for(10);
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0].trigger_time, start + 10);
+
+    uint32_t next;
+    EXPECT_FALSE(deferred_exec_next_trigger(&next));
+}
+
+TEST_F(DeferredExec, RepeatingCallbackKeepsItsCadence) {
+    int id       = 1;
+    repeat_delay = 5;
+    defer(10, &id);
+
+    run_for(20);
+    ASSERT_EQ(calls.size(), 3);
+    EXPECT_EQ(calls[0].trigger_time, start + 10);
+    EXPECT_EQ(calls[1].trigger_time, start + 15);
+    EXPECT_EQ(calls[2].trigger_time, start + 20);
+}
+
+TEST_F(DeferredExec, CallbacksRunInTriggerOrder) {
+    int ids[] = {0, 1, 2, 3};
+    defer(30, &ids[0]);
+    defer(10, &ids[1]);
+    defer(20, &ids[2]);
+    defer(20, &ids[3]);
+
+    uint32_t next;
+    ASSERT_TRUE(deferred_exec_next_trigger(&next));
+    EXPECT_EQ(next, start + 10);
+
+    // Fall behind, so that all of them are due in the same pass
+    advance_time(40);
+    deferred_exec_task();
+    ASSERT_EQ(calls.size(), 4);
+    EXPECT_EQ(calls[0].id, 1);
+    EXPECT_EQ(calls[1].trigger_time, start + 20);
+    EXPECT_EQ(calls[2].trigger_time, start + 20);
+    EXPECT_EQ(calls[3].id, 0);
+    EXPECT_FALSE(deferred_exec_next_trigger(&next));
+}
+
+TEST_F(DeferredExec, LaggingCallbackRunsOncePerPass) {
+    int ids[]    = {0, 1};
+    repeat_delay = 2;
+    defer(10, &ids[0]);
+    defer(15, &ids[1]);
+
+    // Fall far behind, each repeating executor catches up one call per pass without holding back the other
+    advance_time(20);
+    deferred_exec_task();
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[0].id, 0);
+    EXPECT_EQ(calls[0].trigger_time, start + 10);
+    EXPECT_EQ(calls[1].id, 1);
+    EXPECT_EQ(calls[1].trigger_time, start + 15);
+
+    run_for(1);
+    ASSERT_EQ(calls.size(), 4);
+    EXPECT_EQ(calls[2].id, 0);
+    EXPECT_EQ(calls[2].trigger_time, start + 12);
+    EXPECT_EQ(calls[3].id, 1);
+    EXPECT_EQ(calls[3].trigger_time, start + 17);
+}
+
+TEST_F(DeferredExec, ExtendAndCancel) {
+    int            ids[] = {0, 1};
+    deferred_token first = defer(10, &ids[0]);
+    deferred_token later = defer(20, &ids[1]);
+
+    EXPECT_TRUE(extend_deferred_exec(first, 30));
+    uint32_t next;
+    ASSERT_TRUE(deferred_exec_next_trigger(&next));
+    EXPECT_EQ(next, start + 20);
+
+    EXPECT_TRUE(cancel_deferred_exec(later));
+    EXPECT_FALSE(cancel_deferred_exec(later));
+    EXPECT_FALSE(extend_deferred_exec(later, 10));
+    ASSERT_TRUE(deferred_exec_next_trigger(&next));
+    EXPECT_EQ(next, start + 30);
+
+    run_for(30);
+    ASSERT_EQ(calls.size(), 1);
+    EXPECT_EQ(calls[0].id, 0);
+    EXPECT_EQ(calls[0].trigger_time, start + 30);
+}
+
+TEST_F(DeferredExec, StaleTokensDoNotMatchNewExecutions) {
+    int            ids[] = {0, 1};
+    deferred_token stale = defer(1, &ids[0]);
+    run_for(1);
+    ASSERT_EQ(calls.size(), 1);
+
+    deferred_token token = defer(10, &ids[1]);
+    EXPECT_NE(token, stale);
+    EXPECT_FALSE(cancel_deferred_exec(stale));
+
+    run_for(10);
+    ASSERT_EQ(calls.size(), 2);
+    EXPECT_EQ(calls[1].id, 1);
+}
+
+TEST_F(DeferredExec, TokensAreNotReusedSoon) {
+    int            id    = 0;
+    deferred_token stale = defer_exec(10, record_call, &id);
+    cancel_deferred_exec(stale);
+
+    // Keep reusing the same slot, well past the number of tokens a byte could hold
+    for (int i = 0; i < 1000; i++) {
+        deferred_token token = defer_exec(10, record_call, &id);
+        ASSERT_NE(token, stale);
+        EXPECT_FALSE(cancel_deferred_exec(stale));
+        cancel_deferred_exec(token);
+    }
+}
+
+TEST_F(DeferredExec, TableFillsUp) {
+    int ids[MAX_DEFERRED_EXECUTORS + 1];
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        ids[i] = i;
+        EXPECT_NE(defer(100 - i, &ids[i]), INVALID_DEFERRED_TOKEN);
+    }
+    EXPECT_EQ(defer_exec(10, record_call, &ids[MAX_DEFERRED_EXECUTORS]), INVALID_DEFERRED_TOKEN);
+
+    // Every executor runs, latest queued first as it has the shortest delay
+    run_for(100);
+    ASSERT_EQ(calls.size(), MAX_DEFERRED_EXECUTORS);
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        EXPECT_EQ(calls[i].id, MAX_DEFERRED_EXECUTORS - 1 - i);
+    }
+}
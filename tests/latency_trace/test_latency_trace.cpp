@@ -0,0 +1,156 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "latency_trace.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::InvokeWithoutArgs;
+
+// Simulated time spent in the keymap and in the host driver
+#define PROCESS_RECORD_US 200
+#define SEND_REPORT_US 300
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+    advance_time_us(PROCESS_RECORD_US);
+    return true;
+}
+
+class LatencyTrace : public TestFixture {
+   protected:
+    void SetUp() override {
+        latency_trace_clear();
+    }
+
+    static uint32_t stage_time(const latency_trace_t& trace, latency_stage_t from, latency_stage_t to) {
+        return trace.time[to] - trace.time[from];
+    }
+};
+
+TEST_F(LatencyTrace, KeyPressIsTracedThroughEachStage) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 3, 1, KC_A);
+    set_keymap({key});
+
+    key.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key.report_code))).WillOnce(InvokeWithoutArgs([] { advance_time_us(SEND_REPORT_US); }));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    latency_trace_t trace;
+    ASSERT_TRUE(latency_trace_get(0, &trace));
+    EXPECT_EQ(trace.key.row, 1);
+    EXPECT_EQ(trace.key.col, 3);
+    EXPECT_TRUE(trace.pressed);
+    EXPECT_EQ(trace.stages, (1 << LATENCY_STAGE_COUNT) - 1);
+    EXPECT_EQ(stage_time(trace, LATENCY_STAGE_DEBOUNCE, LATENCY_STAGE_ACTION), 0);
+    EXPECT_EQ(stage_time(trace, LATENCY_STAGE_ACTION, LATENCY_STAGE_REPORT), PROCESS_RECORD_US);
+    EXPECT_EQ(stage_time(trace, LATENCY_STAGE_REPORT, LATENCY_STAGE_USB), SEND_REPORT_US);
+    EXPECT_FALSE(latency_trace_get(1, &trace));
+
+    key.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).WillOnce(InvokeWithoutArgs([] { advance_time_us(SEND_REPORT_US); }));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    ASSERT_TRUE(latency_trace_get(0, &trace));
+    EXPECT_FALSE(trace.pressed);
+    EXPECT_EQ(stage_time(trace, LATENCY_STAGE_DEBOUNCE, LATENCY_STAGE_USB), PROCESS_RECORD_US + SEND_REPORT_US);
+}
+
+TEST_F(LatencyTrace, KeysWaitingForAScanAreTracedSeparately) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    key_a.press();
+    key_b.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code))).WillOnce(InvokeWithoutArgs([] { advance_time_us(SEND_REPORT_US); }));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code))).WillOnce(InvokeWithoutArgs([] { advance_time_us(SEND_REPORT_US); }));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    latency_trace_t trace_a, trace_b;
+    ASSERT_TRUE(latency_trace_get(1, &trace_a));
+    ASSERT_TRUE(latency_trace_get(0, &trace_b));
+    EXPECT_EQ(trace_a.key.col, 0);
+    EXPECT_EQ(trace_b.key.col, 1);
+    EXPECT_EQ(trace_a.time[LATENCY_STAGE_DEBOUNCE], trace_b.time[LATENCY_STAGE_DEBOUNCE]);
+
+    // B is only processed on the next scan, one millisecond later
+    EXPECT_EQ(stage_time(trace_a, LATENCY_STAGE_DEBOUNCE, LATENCY_STAGE_ACTION), 0);
+    EXPECT_EQ(stage_time(trace_b, LATENCY_STAGE_DEBOUNCE, LATENCY_STAGE_ACTION), PROCESS_RECORD_US + SEND_REPORT_US + 1000);
+    EXPECT_EQ(stage_time(trace_b, LATENCY_STAGE_ACTION, LATENCY_STAGE_USB), PROCESS_RECORD_US + SEND_REPORT_US);
+
+    key_a.release();
+    key_b.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+    run_one_scan_loop();
+}
+
+TEST_F(LatencyTrace, RawHidReportsTraces) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 2, 0, KC_A);
+    set_keymap({key});
+
+    key.press();
+    EXPECT_CALL(driver, send_keyboard_mock(_));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    uint8_t info[32] = {LATENCY_TRACE_RAW_HID_ID, id_latency_trace_get_info};
+    EXPECT_TRUE(latency_trace_raw_hid_receive(info, sizeof(info)));
+    EXPECT_EQ(info[3], LATENCY_TRACE_SIZE);
+    EXPECT_EQ(info[4], LATENCY_STAGE_COUNT);
+    EXPECT_EQ(info[5] | info[6] << 8 | info[7] << 16 | info[8] << 24, 1000000);
+
+    uint8_t data[32] = {LATENCY_TRACE_RAW_HID_ID, id_latency_trace_get_trace, 0};
+    EXPECT_TRUE(latency_trace_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[1], id_latency_trace_get_trace);
+    EXPECT_EQ(data[3], 0); // row
+    EXPECT_EQ(data[4], 2); // col
+    EXPECT_EQ(data[5], 1); // pressed
+    EXPECT_EQ(data[6], (1 << LATENCY_STAGE_COUNT) - 1);
+    uint32_t action = data[11] | data[12] << 8 | data[13] << 16 | data[14] << 24;
+    uint32_t report = data[15] | data[16] << 8 | data[17] << 16 | data[18] << 24;
+    EXPECT_EQ(report - action, PROCESS_RECORD_US);
+
+    uint8_t missing[32] = {LATENCY_TRACE_RAW_HID_ID, id_latency_trace_get_trace, 1};
+    EXPECT_TRUE(latency_trace_raw_hid_receive(missing, sizeof(missing)));
+    EXPECT_EQ(missing[1], 0xFF);
+
+    uint8_t clear[32] = {LATENCY_TRACE_RAW_HID_ID, id_latency_trace_clear};
+    EXPECT_TRUE(latency_trace_raw_hid_receive(clear, sizeof(clear)));
+    latency_trace_t trace;
+    EXPECT_FALSE(latency_trace_get(0, &trace));
+
+    key.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_));
+    run_one_scan_loop();
+}
@@ -0,0 +1,109 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <random>
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+
+#define TEST_LAYERS 8
+#define TEST_KEYS 6
+
+class LayerResolutionCache : public TestFixture {
+   protected:
+    std::mt19937 rng{0x514D4B};
+    uint16_t     codes[TEST_LAYERS][TEST_KEYS];
+
+    keypos_t key_position(uint8_t key) {
+        return (keypos_t){.col = (uint8_t)(key % MATRIX_COLS), .row = (uint8_t)(key / MATRIX_COLS)};
+    }
+
+    void randomize_keymap() {
+        std::vector<KeymapKey> keys;
+        for (uint8_t layer = 0; layer < TEST_LAYERS; layer++) {
+            for (uint8_t key = 0; key < TEST_KEYS; key++) {
+                codes[layer][key] = (rng() % 3) ? KC_TRNS : (uint16_t)(KC_A + layer);
+                keypos_t pos      = key_position(key);
+                keys.push_back(KeymapKey(layer, pos.col, pos.row, codes[layer][key]));
+            }
+        }
+        keymap.clear();
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    /* Straightforward top-down search, as done without the cache */
+    uint8_t reference_layer(uint8_t key) {
+        layer_state_t layers = layer_state | default_layer_state;
+        for (int8_t layer = TEST_LAYERS - 1; layer >= 0; layer--) {
+            if ((layers & ((layer_state_t)1 << layer)) && codes[layer][key] != KC_TRNS) {
+                return layer;
+            }
+        }
+        return 0;
+    }
+
+    void expect_same_as_reference() {
+        for (uint8_t key = 0; key < TEST_KEYS; key++) {
+            EXPECT_EQ(layer_switch_get_layer(key_position(key)), reference_layer(key)) << "key " << +key << " layers " << layer_state << " default " << default_layer_state;
+        }
+    }
+};
+
+TEST_F(LayerResolutionCache, MatchesResolverAcrossRandomLayerStacks) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    randomize_keymap();
+    for (int i = 0; i < 1000; i++) {
+        switch (rng() % 4) {
+            case 0:
+                layer_state_set(rng() & ((1 << TEST_LAYERS) - 1));
+                break;
+            case 1:
+                layer_invert(rng() % TEST_LAYERS);
+                break;
+            case 2:
+                default_layer_set((layer_state_t)1 << (rng() % TEST_LAYERS));
+                break;
+            case 3:
+                /* layer state written behind the back of layer_state_set() */
+                layer_state = rng() & ((1 << TEST_LAYERS) - 1);
+                break;
+        }
+        expect_same_as_reference();
+    }
+
+    default_layer_set(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerResolutionCache, MatchesResolverAfterKeymapChanges) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    for (int i = 0; i < 50; i++) {
+        randomize_keymap();
+        layer_state_set(rng() & ((1 << TEST_LAYERS) - 1));
+        expect_same_as_reference();
+    }
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,100 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "timer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+static std::vector<keyevent_t> recorded_events;
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+    recorded_events.push_back(record->event);
+    return true;
+}
+
+class MatrixEventQueue : public TestFixture {
+   protected:
+    void SetUp() override {
+        recorded_events.clear();
+    }
+};
+
+TEST_F(MatrixEventQueue, AllKeysChangedInOneScanAreProcessedInThatScan) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_b = KeymapKey(0, 0, 0, KC_B);
+    auto       key_c = KeymapKey(0, 1, 1, KC_C);
+    auto       key_d = KeymapKey(0, 2, 1, KC_D);
+
+    set_keymap({key_b, key_c, key_d});
+
+    key_b.press();
+    key_c.press();
+    key_d.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code, key_c.report_code)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code, key_c.report_code, key_d.report_code)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_c.report_code, key_d.report_code)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_d.report_code)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(MatrixEventQueue, EventsCarryTheTimeOfTheScanThatSettledThem) {
+    TestDriver driver;
+    auto       key_b = KeymapKey(0, 0, 0, KC_B);
+    auto       key_c = KeymapKey(0, 1, 1, KC_C);
+
+    set_keymap({key_b, key_c});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    key_b.press();
+    key_c.press();
+    uint16_t scan_time = timer_read() | 1;
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    ASSERT_EQ(recorded_events.size(), 2);
+    EXPECT_EQ(recorded_events[0].time, scan_time);
+    EXPECT_EQ(recorded_events[1].time, scan_time);
+    EXPECT_TRUE(KEYEQ(recorded_events[0].key, ((keypos_t){.col = 0, .row = 0})));
+    EXPECT_TRUE(KEYEQ(recorded_events[1].key, ((keypos_t){.col = 1, .row = 1})));
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    key_b.release();
+    key_c.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
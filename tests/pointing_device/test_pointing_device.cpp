@@ -0,0 +1,83 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+}
+
+using testing::_;
+using testing::SaveArg;
+
+// Motion returned by the custom driver on its next read
+static int16_t sensor_x = 0, sensor_y = 0;
+
+extern "C" report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
+    mouse_report.x = sensor_x;
+    mouse_report.y = sensor_y;
+    sensor_x = sensor_y = 0;
+    return mouse_report;
+}
+
+class PointingDevice : public TestFixture {
+   protected:
+    void SetUp() override {
+        sensor_x = sensor_y = 0;
+    }
+};
+
+TEST_F(PointingDevice, WideMotionIsSentUnclamped) {
+    TestDriver     driver;
+    report_mouse_t sent = {};
+
+    sensor_x = 1000;
+    sensor_y = -2000;
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillOnce(SaveArg<0>(&sent));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(sent.x, 1000);
+    EXPECT_EQ(sent.y, -2000);
+    EXPECT_EQ(sent.boot_x, 127);
+    EXPECT_EQ(sent.boot_y, -127);
+}
+
+TEST_F(PointingDevice, SmallMotionFitsTheBootReport) {
+    TestDriver     driver;
+    report_mouse_t sent = {};
+
+    sensor_x = -5;
+    sensor_y = 12;
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillOnce(SaveArg<0>(&sent));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(sent.x, -5);
+    EXPECT_EQ(sent.y, 12);
+    EXPECT_EQ(sent.boot_x, -5);
+    EXPECT_EQ(sent.boot_y, 12);
+}
+
+TEST_F(PointingDevice, NoMotionSendsNothing) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    run_one_scan_loop();
+    idle_for(10);
+}
@@ -0,0 +1,189 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "eeconfig.h"
+#include "pointing_device.h"
+#include "pointing_device_accel.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::Invoke;
+
+// Motion returned by the custom driver on every read
+static int8_t sensor_x = 0;
+
+extern "C" report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
+    mouse_report.x = sensor_x;
+    return mouse_report;
+}
+
+class PointingDeviceAccel : public TestFixture {
+   protected:
+    void SetUp() override {
+        sensor_x = 0;
+        pointing_device_accel_init();
+    }
+
+    static void set_curve(pointing_device_accel_curve_t curve, uint8_t offset, uint8_t rate, uint8_t limit, uint8_t exponent = 0) {
+        pointing_device_accel_config_t config = {};
+        config.enable                         = true;
+        config.curve                          = curve;
+        config.offset                         = offset;
+        config.rate                           = rate;
+        config.limit                          = limit;
+        config.exponent                       = exponent;
+        pointing_device_accel_set_config_noeeprom(config);
+    }
+
+    /* Runs a scan per report, returning the x motion of the reports sent */
+    std::vector<int> move(TestDriver& driver, int8_t x, unsigned reports) {
+        std::vector<int> sent;
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([&sent](report_mouse_t& report) { sent.push_back(report.x); }));
+        sensor_x = x;
+        idle_for(reports);
+        sensor_x = 0;
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        return sent;
+    }
+};
+
+TEST_F(PointingDeviceAccel, LinearCurve) {
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 8, 32, 64);
+
+    EXPECT_EQ(pointing_device_accel_get_factor(0), 256);
+    EXPECT_EQ(pointing_device_accel_get_factor(8), 256);
+    EXPECT_EQ(pointing_device_accel_get_factor(16), 512);
+    EXPECT_EQ(pointing_device_accel_get_factor(32), 1024);
+    EXPECT_EQ(pointing_device_accel_get_factor(255), 1024);
+}
+
+TEST_F(PointingDeviceAccel, PowerCurve) {
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_POWER, 0, 64, 255, 4);
+
+    EXPECT_EQ(pointing_device_accel_get_factor(0), 256);
+    EXPECT_EQ(pointing_device_accel_get_factor(4), 512);
+    EXPECT_EQ(pointing_device_accel_get_factor(8), 1280);
+    EXPECT_EQ(pointing_device_accel_get_factor(255), 255 * 16);
+}
+
+TEST_F(PointingDeviceAccel, SigmoidCurve) {
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_SIGMOID, 32, 64, 48);
+
+    EXPECT_EQ(pointing_device_accel_get_factor(0), 256);
+    EXPECT_EQ(pointing_device_accel_get_factor(32), 512);
+    EXPECT_EQ(pointing_device_accel_get_factor(255), 768);
+    for (int speed = 1; speed < 256; speed++) {
+        EXPECT_GE(pointing_device_accel_get_factor(speed), pointing_device_accel_get_factor(speed - 1));
+    }
+}
+
+TEST_F(PointingDeviceAccel, CustomCurveInterpolatesItsPoints) {
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_CUSTOM, 0, 0, 255);
+
+    EXPECT_EQ(pointing_device_accel_get_factor(0), 256);
+    EXPECT_EQ(pointing_device_accel_get_factor(8), 256);
+    EXPECT_EQ(pointing_device_accel_get_factor(16), 512);
+    EXPECT_EQ(pointing_device_accel_get_factor(24), 768);
+    EXPECT_EQ(pointing_device_accel_get_factor(100), 768);
+}
+
+TEST_F(PointingDeviceAccel, InvalidConfigIsIgnored) {
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 8, 32, 64);
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 0, 255, 0);
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_COUNT, 0, 255, 64);
+
+    EXPECT_EQ(pointing_device_accel_get_config().offset, 8);
+    EXPECT_EQ(pointing_device_accel_get_factor(16), 512);
+}
+
+TEST_F(PointingDeviceAccel, ConfigIsSavedAndLoaded) {
+    pointing_device_accel_config_t config = pointing_device_accel_get_config();
+    config.curve                          = POINTING_DEVICE_ACCEL_CURVE_SIGMOID;
+    config.rate                           = 99;
+    pointing_device_accel_set_config(config);
+    EXPECT_EQ(eeconfig_read_pointing_device_accel(), config.raw);
+
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 8, 32, 64);
+    pointing_device_accel_init();
+    EXPECT_EQ(pointing_device_accel_get_config().curve, POINTING_DEVICE_ACCEL_CURVE_SIGMOID);
+    EXPECT_EQ(pointing_device_accel_get_config().rate, 99);
+}
+
+TEST_F(PointingDeviceAccel, SlowMotionIsNotAccelerated) {
+    TestDriver driver;
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 8, 32, 64);
+
+    // 1 count per ms is speed 4, below the offset
+    for (int x : move(driver, 1, 10)) {
+        EXPECT_EQ(x, 1);
+    }
+}
+
+TEST_F(PointingDeviceAccel, FastMotionKeepsFractions) {
+    TestDriver driver;
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 0, 32, 64);
+
+    // 1 count per ms is speed 4, a factor of 1.5 once moving
+    std::vector<int> sent = move(driver, 1, 9);
+    ASSERT_EQ(sent.size(), 9);
+    int total = 0;
+    for (size_t i = 1; i < sent.size(); i++) {
+        EXPECT_GE(sent[i], 1);
+        EXPECT_LE(sent[i], 2);
+        total += sent[i];
+    }
+    EXPECT_EQ(total, 12);
+}
+
+TEST_F(PointingDeviceAccel, SpeedUsesTheSampleTimes) {
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 0, 32, 64);
+    report_mouse_t report = {};
+    report.x              = 4;
+
+    pointing_device_accel_set_sample_time(timer_read());
+    EXPECT_EQ(pointing_device_accel_apply(report).x, 4);
+
+    // Sampled 1 ms after the previous report but processed 4 ms later, speed 16 is a factor of 3
+    uint16_t sampled = timer_read() + 1;
+    advance_time(4);
+    pointing_device_accel_set_sample_time(sampled);
+    EXPECT_EQ(pointing_device_accel_apply(report).x, 12);
+
+    // Without a sample time, the motion is timed when it is accelerated, 4 ms after the last sample at speed 4
+    advance_time(1);
+    EXPECT_EQ(pointing_device_accel_apply(report).x, 6);
+}
+
+TEST_F(PointingDeviceAccel, DisabledPassesMotionThrough) {
+    TestDriver driver;
+    set_curve(POINTING_DEVICE_ACCEL_CURVE_LINEAR, 0, 255, 255);
+    pointing_device_accel_toggle();
+    EXPECT_FALSE(pointing_device_accel_is_enabled());
+
+    for (int x : move(driver, 10, 5)) {
+        EXPECT_EQ(x, 10);
+    }
+    pointing_device_accel_toggle();
+}
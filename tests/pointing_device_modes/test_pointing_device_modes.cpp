@@ -0,0 +1,227 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+#include "pointing_device_modes.h"
+}
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::SaveArg;
+
+// Motion returned by the custom driver on its next read
+static int16_t sensor_x = 0, sensor_y = 0;
+static int8_t  sensor_v = 0;
+
+extern "C" report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
+    mouse_report.x = sensor_x;
+    mouse_report.y = sensor_y;
+    mouse_report.v = sensor_v;
+    sensor_x = sensor_y = sensor_v = 0;
+    return mouse_report;
+}
+
+class PointingDeviceModes : public TestFixture {
+   protected:
+    void SetUp() override {
+        sensor_x = sensor_y = sensor_v = 0;
+        host_mouse_set_resolution(0);
+        pointing_device_set_mode(POINTING_DEVICE_MODE_POINTER);
+        pointing_device_set_caret_keycodes(KC_RIGHT, KC_LEFT, KC_UP, KC_DOWN);
+    }
+
+    // Moves the sensor and returns the mouse report that is sent
+    report_mouse_t move(TestDriver &driver, int16_t x, int16_t y) {
+        report_mouse_t sent = {};
+        sensor_x            = x;
+        sensor_y            = y;
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillOnce(SaveArg<0>(&sent));
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        return sent;
+    }
+};
+
+TEST_F(PointingDeviceModes, PointerModeMovesThePointer) {
+    TestDriver driver;
+
+    report_mouse_t sent = move(driver, 5, -7);
+    EXPECT_EQ(sent.x, 5);
+    EXPECT_EQ(sent.y, -7);
+    EXPECT_EQ(sent.v, 0);
+    EXPECT_EQ(sent.h, 0);
+}
+
+TEST_F(PointingDeviceModes, ScrollModeSendsWholeDetents) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_SCROLL);
+
+    report_mouse_t sent = move(driver, POINTING_DEVICE_SCROLL_DIVISOR, -POINTING_DEVICE_SCROLL_DIVISOR * 3 / 2);
+    EXPECT_EQ(sent.x, 0);
+    EXPECT_EQ(sent.y, 0);
+    EXPECT_EQ(sent.h, 1);
+    EXPECT_EQ(sent.v, 1);
+
+    // The half detent left over adds up with the next motion
+    sent = move(driver, 0, -POINTING_DEVICE_SCROLL_DIVISOR / 2);
+    EXPECT_EQ(sent.h, 0);
+    EXPECT_EQ(sent.v, 1);
+}
+
+TEST_F(PointingDeviceModes, ScrollModeUsesTheResolutionSetByTheHost) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_SCROLL);
+    host_mouse_set_resolution(MOUSE_RESOLUTION_WHEEL | MOUSE_RESOLUTION_PAN);
+
+    report_mouse_t sent = move(driver, -4, 8);
+    EXPECT_EQ(sent.h, -4 * MOUSE_HIRES_SCROLL_MULTIPLIER / POINTING_DEVICE_SCROLL_DIVISOR);
+    EXPECT_EQ(sent.v, -8 * MOUSE_HIRES_SCROLL_MULTIPLIER / POINTING_DEVICE_SCROLL_DIVISOR);
+}
+
+TEST_F(PointingDeviceModes, ScrollModeCarriesWhatDoesNotFitTheReport) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_SCROLL);
+    host_mouse_set_resolution(MOUSE_RESOLUTION_WHEEL);
+
+    // Two detents, more than a report holds at this resolution
+    report_mouse_t sent = move(driver, 0, -POINTING_DEVICE_SCROLL_DIVISOR * 2);
+    EXPECT_EQ(sent.v, 127);
+
+    sent = move(driver, 0, 0);
+    EXPECT_EQ(sent.v, MOUSE_HIRES_SCROLL_MULTIPLIER * 2 - 127);
+}
+
+TEST_F(PointingDeviceModes, DriverDetentsUseTheResolutionSetByTheHost) {
+    TestDriver driver;
+    host_mouse_set_resolution(MOUSE_RESOLUTION_WHEEL);
+
+    report_mouse_t sent = {};
+    sensor_v            = -1;
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillOnce(SaveArg<0>(&sent));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(sent.v, -MOUSE_HIRES_SCROLL_MULTIPLIER);
+}
+
+TEST_F(PointingDeviceModes, MousekeyWheelUsesTheResolutionSetByTheHost) {
+    TestDriver driver;
+    auto       wheel_up = KeymapKey(0, 0, 0, KC_MS_WH_UP);
+    set_keymap({wheel_up});
+
+    for (uint8_t resolution : {0, MOUSE_RESOLUTION_WHEEL}) {
+        host_mouse_set_resolution(resolution);
+        std::vector<int8_t> wheel;
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([&wheel](report_mouse_t &report) {
+            if (report.v) wheel.push_back(report.v);
+        }));
+        wheel_up.press();
+        run_one_scan_loop();
+        wheel_up.release();
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        ASSERT_EQ(wheel.size(), 1);
+        EXPECT_EQ(wheel[0], resolution ? MOUSE_HIRES_SCROLL_MULTIPLIER : 1);
+    }
+}
+
+TEST_F(PointingDeviceModes, SwitchingModesDropsAccumulatedMotion) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_SCROLL);
+
+    // Half a detent does not scroll yet
+    sensor_y = -POINTING_DEVICE_SCROLL_DIVISOR / 2;
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    pointing_device_set_mode(POINTING_DEVICE_MODE_CARET);
+    pointing_device_set_mode(POINTING_DEVICE_MODE_SCROLL);
+    sensor_y = -POINTING_DEVICE_SCROLL_DIVISOR / 2;
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    report_mouse_t sent = move(driver, 0, -POINTING_DEVICE_SCROLL_DIVISOR / 2);
+    EXPECT_EQ(sent.v, 1);
+}
+
+TEST_F(PointingDeviceModes, CaretModeTapsAtALimitedRate) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_CARET);
+
+    sensor_x = POINTING_DEVICE_CARET_DIVISOR * 3;
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_RIGHT)));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The other key events wait for their turn
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(POINTING_DEVICE_CARET_INTERVAL_MS - 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_RIGHT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_RIGHT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    idle_for(POINTING_DEVICE_CARET_INTERVAL_MS * 6);
+}
+
+TEST_F(PointingDeviceModes, CaretModeFollowsTheDominantAxis) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_CARET);
+    pointing_device_set_caret_keycodes(KC_L, KC_H, KC_K, KC_J);
+
+    sensor_x = -POINTING_DEVICE_CARET_DIVISOR / 2;
+    sensor_y = -POINTING_DEVICE_CARET_DIVISOR;
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(0);
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_K)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    idle_for(POINTING_DEVICE_CARET_INTERVAL_MS * 3);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The sideways motion was dropped with the tap
+    sensor_x = -POINTING_DEVICE_CARET_DIVISOR / 2;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(POINTING_DEVICE_CARET_INTERVAL_MS * 3);
+}
+
+TEST_F(PointingDeviceModes, CaretModeDropsTapsBeyondTheQueue) {
+    TestDriver driver;
+    pointing_device_set_mode(POINTING_DEVICE_MODE_CARET);
+
+    sensor_y = POINTING_DEVICE_CARET_DIVISOR * (POINTING_DEVICE_CARET_QUEUE_SIZE + 4);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_DOWN))).Times(POINTING_DEVICE_CARET_QUEUE_SIZE);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(POINTING_DEVICE_CARET_QUEUE_SIZE);
+    idle_for(POINTING_DEVICE_CARET_INTERVAL_MS * (POINTING_DEVICE_CARET_QUEUE_SIZE + 4) * 2);
+}
@@ -0,0 +1,179 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+static uint8_t leds[DRIVER_LED_TOTAL][3];
+static int     set_color_calls = 0;
+static int     flush_calls     = 0;
+static uint8_t flushed_first   = 0;
+static uint8_t flushed_last    = 0;
+static bool    draw_indicator  = false;
+
+extern "C" {
+static void driver_init(void) {}
+
+static void driver_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    set_color_calls++;
+    leds[index][0] = r;
+    leds[index][1] = g;
+    leds[index][2] = b;
+}
+
+static void driver_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        driver_set_color(i, r, g, b);
+    }
+}
+
+static void driver_flush_range(uint8_t first, uint8_t last) {
+    flush_calls++;
+    flushed_first = first;
+    flushed_last  = last;
+}
+
+static void driver_flush(void) {
+    driver_flush_range(0, DRIVER_LED_TOTAL - 1);
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {driver_init, driver_set_color, driver_set_color_all, driver_flush, driver_flush_range};
+
+// clang-format off
+led_config_t g_led_config = {{
+    {0,      1,      2,      3,      NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+}, {
+    {0, 0}, {75, 0}, {150, 0}, {224, 0}
+}, {
+    4, 4, 4, 4
+}};
+// clang-format on
+
+void rgb_matrix_indicators_user(void) {
+    if (draw_indicator) {
+        rgb_matrix_set_color(2, 255, 255, 255);
+    }
+}
+}
+
+class RgbMatrixDirtyTracking : public TestFixture {
+   protected:
+    void SetUp() override {
+        TestDriver driver;
+        draw_indicator = false;
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        rgb_matrix_sethsv_noeeprom(0, 255, 255);
+        idle_for(100);
+        reset_counters();
+    }
+
+    static void reset_counters() {
+        set_color_calls = 0;
+        flush_calls     = 0;
+    }
+
+    static bool led_matches(uint8_t index, uint8_t other) {
+        return memcmp(leds[index], leds[other], sizeof(leds[0])) == 0;
+    }
+};
+
+TEST_F(RgbMatrixDirtyTracking, StaticEffectIsOnlyFlushedOnce) {
+    TestDriver driver;
+
+    EXPECT_EQ(leds[0][0], 255);
+    EXPECT_TRUE(led_matches(0, 3));
+
+    idle_for(100);
+    EXPECT_EQ(set_color_calls, 0);
+    EXPECT_EQ(flush_calls, 0);
+}
+
+TEST_F(RgbMatrixDirtyTracking, ConfigChangeRedrawsStaticEffect) {
+    TestDriver driver;
+    rgb_matrix_sethsv_noeeprom(0, 0, 255);
+    idle_for(100);
+    EXPECT_EQ(set_color_calls, DRIVER_LED_TOTAL);
+    EXPECT_EQ(flush_calls, 1);
+    EXPECT_EQ(flushed_first, 0);
+    EXPECT_EQ(flushed_last, DRIVER_LED_TOTAL - 1);
+    EXPECT_EQ(leds[1][1], 255);
+}
+
+TEST_F(RgbMatrixDirtyTracking, IndicatorIsPaintedOverOnceRemoved) {
+    TestDriver driver;
+    draw_indicator = true;
+    idle_for(100);
+    EXPECT_EQ(leds[2][1], 255);
+    EXPECT_GT(flush_calls, 1);
+    EXPECT_EQ(flushed_first, 2);
+    EXPECT_EQ(flushed_last, 2);
+
+    draw_indicator = false;
+    idle_for(100);
+    EXPECT_TRUE(led_matches(2, 0));
+
+    reset_counters();
+    idle_for(100);
+    EXPECT_EQ(flush_calls, 0);
+}
+
+TEST_F(RgbMatrixDirtyTracking, AnimatedEffectIsFlushedEveryFrame) {
+    TestDriver driver;
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_CYCLE_ALL);
+    idle_for(100);
+    EXPECT_GT(flush_calls, 4);
+}
+
+TEST_F(RgbMatrixDirtyTracking, ReactiveEffectStopsOnceHitsExpire) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 1, 0, KC_A);
+    set_keymap({key});
+
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+    idle_for(100);
+    reset_counters();
+    idle_for(100);
+    EXPECT_EQ(flush_calls, 0);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    key.press();
+    run_one_scan_loop();
+    key.release();
+    idle_for(100);
+    EXPECT_GT(flush_calls, 0);
+    EXPECT_EQ(flushed_first, 1);
+
+    // hits are tracked until their tick saturates
+    idle_for(UINT16_MAX);
+    reset_counters();
+    idle_for(100);
+    EXPECT_EQ(flush_calls, 0);
+}
@@ -0,0 +1,139 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+#include "lib/lib8tion/lib8tion.h"
+
+extern const led_point_t k_rgb_matrix_center;
+}
+
+static uint8_t leds[DRIVER_LED_TOTAL][3];
+
+extern "C" {
+static void driver_init(void) {}
+
+static void driver_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    leds[index][0] = r;
+    leds[index][1] = g;
+    leds[index][2] = b;
+}
+
+static void driver_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        driver_set_color(i, r, g, b);
+    }
+}
+
+static void driver_flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {driver_init, driver_set_color, driver_set_color_all, driver_flush};
+
+// clang-format off
+led_config_t g_led_config = {{
+    {0,      1,      2,      3,      4,      5,      NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+}, {
+    {0, 0}, {45, 10}, {90, 20}, {134, 30}, {179, 40}, {224, 64}
+}, {
+    4, 4, 2, 4, 1, 4
+}};
+// clang-format on
+}
+
+class RgbMatrixLedCache : public TestFixture {
+   protected:
+    void SetUp() override {
+        TestDriver driver;
+        rgb_matrix_set_flags(LED_FLAG_KEYLIGHT);
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        rgb_matrix_sethsv_noeeprom(0, 255, 255);
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+    }
+
+    static bool lit(uint8_t index) {
+        return leds[index][0] || leds[index][1] || leds[index][2];
+    }
+};
+
+TEST_F(RgbMatrixLedCache, OnlyLedsMatchingTheFlagsAreCachedAndLit) {
+    TestDriver driver;
+
+    const uint8_t expected[] = {0, 1, 3, 5};
+    ASSERT_EQ(g_rgb_led_cache.count, sizeof(expected));
+    for (uint8_t n = 0; n < sizeof(expected); n++) {
+        EXPECT_EQ(g_rgb_led_cache.index[n], expected[n]);
+    }
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_EQ(lit(i), HAS_ANY_FLAGS(g_led_config.flags[i], LED_FLAG_KEYLIGHT)) << "LED " << (int)i;
+    }
+}
+
+TEST_F(RgbMatrixLedCache, FindReturnsTheFirstCachedLedInRange) {
+    TestDriver driver;
+
+    EXPECT_EQ(rgb_matrix_led_cache_find(0), 0);
+    EXPECT_EQ(rgb_matrix_led_cache_find(2), 2);
+    EXPECT_EQ(rgb_matrix_led_cache_find(3), 2);
+    EXPECT_EQ(rgb_matrix_led_cache_find(4), 3);
+    EXPECT_EQ(rgb_matrix_led_cache_find(DRIVER_LED_TOTAL), g_rgb_led_cache.count);
+}
+
+TEST_F(RgbMatrixLedCache, DistancesAreMeasuredFromTheCenter) {
+    TestDriver driver;
+
+    for (uint8_t n = 0; n < g_rgb_led_cache.count; n++) {
+        uint8_t i  = g_rgb_led_cache.index[n];
+        int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+        EXPECT_EQ(g_rgb_led_cache.dist[i], sqrt16(dx * dx + dy * dy)) << "LED " << (int)i;
+    }
+}
+
+TEST_F(RgbMatrixLedCache, FlagChangeRebuildsTheCache) {
+    TestDriver driver;
+
+    rgb_matrix_set_flags(LED_FLAG_UNDERGLOW);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+
+    ASSERT_EQ(g_rgb_led_cache.count, 1);
+    EXPECT_EQ(g_rgb_led_cache.index[0], 2);
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_EQ(lit(i), i == 2) << "LED " << (int)i;
+    }
+}
+
+TEST_F(RgbMatrixLedCache, InvalidatingPicksUpLedConfigChanges) {
+    TestDriver driver;
+
+    g_led_config.flags[4] = LED_FLAG_KEYLIGHT;
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+    EXPECT_FALSE(lit(4));
+
+    rgb_matrix_led_cache_invalidate();
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 4);
+    EXPECT_TRUE(lit(4));
+    EXPECT_EQ(g_rgb_led_cache.count, 5);
+
+    g_led_config.flags[4] = LED_FLAG_MODIFIER;
+    rgb_matrix_led_cache_invalidate();
+}
@@ -0,0 +1,171 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+using testing::_;
+
+extern "C" {
+static void driver_init(void) {}
+static void driver_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {}
+static void driver_set_color_all(uint8_t r, uint8_t g, uint8_t b) {}
+static void driver_flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {driver_init, driver_set_color, driver_set_color_all, driver_flush};
+
+// The test keyboard is the left half: rows 0 and 1 are local, rows 2 and 3 belong to the right half
+// clang-format off
+led_config_t g_led_config = {{
+    {0,      1,      NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {2,      3,      NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+    {NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED, NO_LED},
+}, {
+    {0, 0}, {75, 0}, {150, 0}, {224, 0}
+}, {
+    4, 4, 4, 4
+}};
+// clang-format on
+}
+
+class RgbMatrixSplitHits : public TestFixture {
+   protected:
+    // Hits of the simulated right half, kept across tests as the receiving side remembers what it replayed
+    static rgb_key_hits_t remote_hits;
+
+    void SetUp() override {
+        TestDriver driver;
+        rgb_matrix_init();
+        idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+    }
+
+    static rgb_key_hits_t local_hits() {
+        rgb_key_hits_t hits;
+        rgb_matrix_get_split_hits(&hits);
+        return hits;
+    }
+
+    static void add_remote_hit(uint8_t row, uint8_t col, uint16_t age) {
+        rgb_key_hit_t *hit = &remote_hits.hits[remote_hits.head % SPLIT_RGB_MATRIX_HITS_SIZE];
+        hit->row           = row;
+        hit->col           = col;
+        hit->pressed       = true;
+        hit->time          = timer_read() - age;
+        remote_hits.head++;
+    }
+};
+
+rgb_key_hits_t RgbMatrixSplitHits::remote_hits = {};
+
+TEST_F(RgbMatrixSplitHits, LocalKeyIsRecordedForTheOtherHalf) {
+    TestDriver driver;
+    auto       key  = KeymapKey(0, 1, 0, KC_A);
+    uint8_t    head = local_hits().head;
+    set_keymap({key});
+
+    key.press();
+    EXPECT_CALL(driver, send_keyboard_mock(_));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+
+    rgb_key_hits_t hits = local_hits();
+    ASSERT_EQ(hits.head, (uint8_t)(head + 1));
+    EXPECT_EQ(hits.hits[head % SPLIT_RGB_MATRIX_HITS_SIZE].row, 0);
+    EXPECT_EQ(hits.hits[head % SPLIT_RGB_MATRIX_HITS_SIZE].col, 1);
+    EXPECT_TRUE(hits.hits[head % SPLIT_RGB_MATRIX_HITS_SIZE].pressed);
+    ASSERT_EQ(g_last_hit_tracker.count, 1);
+    EXPECT_EQ(g_last_hit_tracker.index[0], 1);
+
+    key.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_));
+    run_one_scan_loop();
+}
+
+TEST_F(RgbMatrixSplitHits, OtherHalfKeyIsLeftToItsHits) {
+    TestDriver driver;
+    auto       key  = KeymapKey(0, 1, 2, KC_B);
+    uint8_t    head = local_hits().head;
+    set_keymap({key});
+
+    key.press();
+    EXPECT_CALL(driver, send_keyboard_mock(_));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+
+    EXPECT_EQ(local_hits().head, head);
+    EXPECT_EQ(g_last_hit_tracker.count, 0);
+
+    key.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_));
+    run_one_scan_loop();
+}
+
+TEST_F(RgbMatrixSplitHits, ReceivedHitsAreReplayedOnceWithTheirAge) {
+    TestDriver driver;
+
+    add_remote_hit(2, 1, 50);
+    rgb_matrix_receive_split_hits(&remote_hits);
+    rgb_matrix_receive_split_hits(&remote_hits);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+
+    ASSERT_EQ(g_last_hit_tracker.count, 1);
+    EXPECT_EQ(g_last_hit_tracker.index[0], 3);
+    EXPECT_GE(g_last_hit_tracker.tick[0], 50);
+    EXPECT_LT(g_last_hit_tracker.tick[0], 50 + RGB_MATRIX_LED_FLUSH_LIMIT * 3);
+}
+
+TEST_F(RgbMatrixSplitHits, TooManyMissedHitsAreDropped) {
+    TestDriver driver;
+
+    for (int i = 0; i <= SPLIT_RGB_MATRIX_HITS_SIZE; i++) {
+        add_remote_hit(2, 0, 0);
+    }
+    rgb_matrix_receive_split_hits(&remote_hits);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+    EXPECT_EQ(g_last_hit_tracker.count, 0);
+
+    add_remote_hit(2, 0, 0);
+    rgb_matrix_receive_split_hits(&remote_hits);
+    idle_for(RGB_MATRIX_LED_FLUSH_LIMIT * 2);
+    ASSERT_EQ(g_last_hit_tracker.count, 1);
+    EXPECT_EQ(g_last_hit_tracker.index[0], 2);
+}
+
+TEST_F(RgbMatrixSplitHits, FramesStartOnSyncTimerBoundaries) {
+    TestDriver driver;
+
+    uint32_t frame_start = g_rgb_timer;
+    for (int frames = 0; frames < 4;) {
+        run_one_scan_loop();
+        if (g_rgb_timer != frame_start) {
+            EXPECT_EQ(g_rgb_timer / RGB_MATRIX_LED_FLUSH_LIMIT, frame_start / RGB_MATRIX_LED_FLUSH_LIMIT + 1);
+            EXPECT_EQ(g_rgb_timer - frame_start, RGB_MATRIX_LED_FLUSH_LIMIT);
+            frame_start = g_rgb_timer;
+            frames++;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "scan_profiler.h"
+}
+
+using testing::_;
+
+class ScanProfiler : public TestFixture {
+   protected:
+    void SetUp() override {
+        scan_profiler_reset();
+    }
+};
+
+TEST_F(ScanProfiler, StatsSummariseRecordedDurations) {
+    scan_profile_stats_t stats;
+
+    for (int i = 0; i < 99; i++) {
+        scan_profiler_record(PROFILE_OLED, 10);
+    }
+    scan_profiler_record(PROFILE_OLED, 1000);
+    scan_profiler_record(PROFILE_OLED, 3);
+
+    scan_profiler_get_stats(PROFILE_OLED, &stats);
+    EXPECT_EQ(stats.count, 101);
+    EXPECT_EQ(stats.min, 3);
+    EXPECT_EQ(stats.max, 1000);
+    EXPECT_EQ(stats.avg, (99 * 10 + 1000 + 3) / 101);
+    // 10 lands in the [8, 11] bucket, which holds the 99th percentile
+    EXPECT_EQ(stats.p99, 11);
+
+    scan_profiler_get_stats(PROFILE_COMBO, &stats);
+    EXPECT_EQ(stats.count, 0);
+}
+
+TEST_F(ScanProfiler, P99FollowsTheSlowestPercent) {
+    scan_profile_stats_t stats;
+
+    for (int i = 0; i < 90; i++) {
+        scan_profiler_record(PROFILE_OLED, 10);
+    }
+    for (int i = 0; i < 10; i++) {
+        scan_profiler_record(PROFILE_OLED, 500);
+    }
+
+    scan_profiler_get_stats(PROFILE_OLED, &stats);
+    EXPECT_EQ(stats.p99, 500);
+}
+
+TEST_F(ScanProfiler, KeyboardTaskIsProfiled) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    scan_profile_stats_t stats;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+
+    scan_profiler_get_stats(PROFILE_KEYBOARD_TASK, &stats);
+    EXPECT_EQ(stats.count, 2);
+    scan_profiler_get_stats(PROFILE_MATRIX_SCAN, &stats);
+    EXPECT_EQ(stats.count, 2);
+    scan_profiler_get_stats(PROFILE_QUANTUM_TASK, &stats);
+    EXPECT_EQ(stats.count, 2);
+}
+
+TEST_F(ScanProfiler, RawHidReportsStats) {
+    uint8_t data[32] = {SCAN_PROFILER_RAW_HID_ID, id_scan_profiler_get_info};
+    EXPECT_TRUE(scan_profiler_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[3], PROFILE_COUNT);
+    EXPECT_EQ(data[4] | data[5] << 8 | data[6] << 16 | data[7] << 24, scan_profiler_clock_hz());
+
+    scan_profiler_record(PROFILE_COMBO, 300);
+    uint8_t stats[32] = {SCAN_PROFILER_RAW_HID_ID, id_scan_profiler_get_stats, PROFILE_COMBO};
+    EXPECT_TRUE(scan_profiler_raw_hid_receive(stats, sizeof(stats)));
+    EXPECT_EQ(stats[1], id_scan_profiler_get_stats);
+    EXPECT_EQ(stats[3], 1);                     // count
+    EXPECT_EQ(stats[7] | stats[8] << 8, 300);   // min
+    EXPECT_EQ(stats[15] | stats[16] << 8, 300); // max
+    EXPECT_EQ(std::string((char*)&stats[23], 5), "combo");
+
+    uint8_t bad[32] = {SCAN_PROFILER_RAW_HID_ID, id_scan_profiler_get_stats, PROFILE_COUNT};
+    EXPECT_TRUE(scan_profiler_raw_hid_receive(bad, sizeof(bad)));
+    EXPECT_EQ(bad[1], 0xFF);
+
+    uint8_t other[32] = {0x01};
+    EXPECT_FALSE(scan_profiler_raw_hid_receive(other, sizeof(other)));
+}
@@ -16,6 +16,12 @@
 
 #include "test_driver.hpp"
 
+#ifdef LATENCY_TRACE_ENABLE
+extern "C" {
+#    include "latency_trace.h"
+}
+#endif
+
 TestDriver* TestDriver::m_this = nullptr;
 
 TestDriver::TestDriver() : m_driver{&TestDriver::keyboard_leds, &TestDriver::send_keyboard, &TestDriver::send_mouse, &TestDriver::send_system, &TestDriver::send_consumer} {
@@ -34,6 +40,10 @@ uint8_t TestDriver::keyboard_leds(void) {
 void TestDriver::send_keyboard(report_keyboard_t* report) {
     test_logger.trace() << *report;
     m_this->send_keyboard_mock(*report);
+#ifdef LATENCY_TRACE_ENABLE
+    // The simulated host collects each report as soon as it is sent
+    latency_trace_report_delivered();
+#endif
 }
 
 void TestDriver::send_mouse(report_mouse_t* report) {
@@ -99,6 +99,7 @@ void TestFixture::add_key(KeymapKey key) {
     }
 
     this->keymap.push_back(key);
+    clear_resolved_layers_cache();
 }
 
 void TestFixture::set_keymap(std::initializer_list<KeymapKey> keys) {
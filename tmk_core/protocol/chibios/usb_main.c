@@ -53,6 +53,10 @@ extern keymap_config_t keymap_config;
 #    include "joystick.h"
 #endif
 
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+
 /* ---------------------------------------------------------
  *       Global interface variables and declarations
  * ---------------------------------------------------------
@@ -472,6 +476,10 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             return;
 
         case USB_EVENT_CONFIGURED:
+#ifdef MOUSE_HIRES_SCROLL
+            /* Feature reports return to their defaults until the host sets them again */
+            host_mouse_set_resolution(0);
+#endif
             osalSysLockFromISR();
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
@@ -566,6 +574,27 @@ static void    set_led_transfer_cb(USBDriver *usbp) {
     }
 }
 
+#ifdef MOUSE_HIRES_SCROLL
+/* Resolution Multiplier, the only feature report */
+#    ifdef MOUSE_SHARED_EP
+#        define MOUSE_RESOLUTION_INTERFACE SHARED_INTERFACE
+static uint8_t mouse_resolution_buf[2] __attribute__((aligned(4)));
+#    else
+#        define MOUSE_RESOLUTION_INTERFACE MOUSE_INTERFACE
+static uint8_t mouse_resolution_buf[1] __attribute__((aligned(4)));
+#    endif
+
+static void set_mouse_resolution_transfer_cb(USBDriver *usbp) {
+#    ifdef MOUSE_SHARED_EP
+    if (mouse_resolution_buf[0] == REPORT_ID_MOUSE) {
+        host_mouse_set_resolution(mouse_resolution_buf[1]);
+    }
+#    else
+    host_mouse_set_resolution(mouse_resolution_buf[0]);
+#    endif
+}
+#endif
+
 /* Callback for SETUP request on the endpoint 0 (control) */
 static bool usb_request_hook_cb(USBDriver *usbp) {
     const USBDescriptor *dp;
@@ -583,6 +612,16 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
             case USB_RTYPE_DIR_DEV2HOST:
                 switch (usbp->setup[1]) { /* bRequest */
                     case HID_GET_REPORT:
+#ifdef MOUSE_HIRES_SCROLL
+                        if ((usbp->setup[3] == HID_REPORT_TYPE_FEATURE) && (usbp->setup[4] == MOUSE_RESOLUTION_INTERFACE)) { /* MSB(wValue), LSB(wIndex) */
+#    ifdef MOUSE_SHARED_EP
+                            mouse_resolution_buf[0] = REPORT_ID_MOUSE;
+#    endif
+                            mouse_resolution_buf[sizeof(mouse_resolution_buf) - 1] = host_mouse_get_resolution();
+                            usbSetupTransfer(usbp, mouse_resolution_buf, sizeof(mouse_resolution_buf), NULL);
+                            return TRUE;
+                        }
+#endif
                         switch (usbp->setup[4]) { /* LSB(wIndex) (check MSB==0?) */
                             case KEYBOARD_INTERFACE:
                                 usbSetupTransfer(usbp, (uint8_t *)&keyboard_report_sent, sizeof(keyboard_report_sent), NULL);
@@ -620,6 +659,12 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
             case USB_RTYPE_DIR_HOST2DEV:
                 switch (usbp->setup[1]) { /* bRequest */
                     case HID_SET_REPORT:
+#ifdef MOUSE_HIRES_SCROLL
+                        if ((usbp->setup[3] == HID_REPORT_TYPE_FEATURE) && (usbp->setup[4] == MOUSE_RESOLUTION_INTERFACE)) { /* MSB(wValue), LSB(wIndex) */
+                            usbSetupTransfer(usbp, mouse_resolution_buf, sizeof(mouse_resolution_buf), set_mouse_resolution_transfer_cb);
+                            return TRUE;
+                        }
+#endif
                         switch (usbp->setup[4]) { /* LSB(wIndex) (check MSB==0?) */
                             case KEYBOARD_INTERFACE:
 #if defined(SHARED_EP_ENABLE) && !defined(KEYBOARD_SHARED_EP)
@@ -688,9 +733,16 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
     return FALSE;
 }
 
+#if defined(MOUSE_ENABLE) && defined(USB_MOUSE_COALESCE)
+static void mouse_sof_cb(USBDriver *usbp);
+#endif
+
 /* Start-of-frame callback */
 static void usb_sof_cb(USBDriver *usbp) {
     kbd_sof_cb(usbp);
+#if defined(MOUSE_ENABLE) && defined(USB_MOUSE_COALESCE)
+    mouse_sof_cb(usbp);
+#endif
     osalSysLockFromISR();
     for (int i = 0; i < NUM_USB_DRIVERS; i++) {
         qmkusbSOFHookI(&drivers.array[i].driver);
@@ -766,9 +818,11 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
     (void)usbp;
     (void)ep;
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_report_delivered();
+#    endif
 }
 #endif
 
@@ -897,6 +951,128 @@ void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
 }
 #    endif
 
+#    ifdef USB_MOUSE_COALESCE
+#        ifndef USB_MOUSE_LATENCY_BUCKET_US
+#            define USB_MOUSE_LATENCY_BUCKET_US 100
+#        endif
+
+/* Report coalescing: send_mouse() adds the motion up into a pending report instead of waiting for the endpoint, and the
+ * start-of-frame handler passes it on once the endpoint is free. The sensor is still read by the main loop at its own
+ * pace, start-of-frame only decides when the motion gathered so far goes out */
+static report_mouse_t    mouse_report_pending;
+static report_mouse_t    mouse_report_sent;
+static bool              mouse_report_queued = false;
+static systime_t         mouse_report_time;
+static systime_t         mouse_sample_time;
+static bool              mouse_sample_time_set = false;
+static volatile uint16_t mouse_latency[USB_MOUSE_LATENCY_BUCKETS];
+
+static inline int8_t mouse_coalesce_merge(int16_t a, int16_t b) {
+    int16_t sum = a + b;
+    return sum < -127 ? -127 : (sum > 127 ? 127 : sum);
+}
+
+static inline mouse_xy_report_t mouse_coalesce_merge_xy(mouse_xy_report_t a, mouse_xy_report_t b) {
+    int32_t sum = (int32_t)a + b;
+    return sum < MOUSE_REPORT_XY_MIN ? MOUSE_REPORT_XY_MIN : (sum > MOUSE_REPORT_XY_MAX ? MOUSE_REPORT_XY_MAX : sum);
+}
+
+/* Hands the pending report over to the idle endpoint.
+ * locked state */
+static void mouse_transmit_pending(USBDriver *usbp) {
+    // Record how long ago the oldest motion in the report was sampled
+    uint32_t bucket = TIME_I2US(chVTTimeElapsedSinceX(mouse_report_time)) / USB_MOUSE_LATENCY_BUCKET_US;
+    if (bucket >= USB_MOUSE_LATENCY_BUCKETS) {
+        bucket = USB_MOUSE_LATENCY_BUCKETS - 1;
+    }
+    if (mouse_latency[bucket] < UINT16_MAX) {
+        mouse_latency[bucket]++;
+    }
+
+    mouse_report_sent      = mouse_report_pending;
+    mouse_report_pending.x = mouse_report_pending.y = mouse_report_pending.v = mouse_report_pending.h = 0;
+    mouse_report_queued    = false;
+    usbStartTransmitI(usbp, MOUSE_IN_EPNUM, (uint8_t *)&mouse_report_sent, sizeof(report_mouse_t));
+}
+
+/* Hands the report coalesced since the last frame over to the endpoint, so the host collects it at its next poll.
+ * called from ISR, unlocked state */
+static void mouse_sof_cb(USBDriver *usbp) {
+    osalSysLockFromISR();
+    if (mouse_report_queued && usbGetDriverStateI(usbp) == USB_ACTIVE && !usbGetTransmitStatusI(usbp, MOUSE_IN_EPNUM)) {
+        mouse_transmit_pending(usbp);
+    }
+    osalSysUnlockFromISR();
+}
+
+/* Sets the time the oldest motion of the next report was sampled, the time of the send_mouse() call is used otherwise */
+void usb_mouse_set_sample_time(systime_t time) {
+    osalSysLock();
+    mouse_sample_time     = time;
+    mouse_sample_time_set = true;
+    osalSysUnlock();
+}
+
+/* Copies out the latency histogram, optionally resetting it */
+void usb_mouse_latency(uint16_t histogram[USB_MOUSE_LATENCY_BUCKETS], bool reset) {
+    osalSysLock();
+    for (uint8_t i = 0; i < USB_MOUSE_LATENCY_BUCKETS; i++) {
+        histogram[i] = mouse_latency[i];
+        if (reset) {
+            mouse_latency[i] = 0;
+        }
+    }
+    osalSysUnlock();
+}
+
+/* Coalesces the report into the one sent at the next start-of-frame. Only waits when the buttons change while a
+ * report is pending, as merging would lose the press or release */
+void send_mouse(report_mouse_t *report) {
+    osalSysLock();
+    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+        mouse_sample_time_set = false;
+        osalSysUnlock();
+        return;
+    }
+
+    bool changed = mouse_report_pending.buttons != report->buttons;
+#        ifdef MOUSE_SHARED_EP
+    changed |= mouse_report_pending.report_id != report->report_id;
+#        endif
+    if (mouse_report_queued && changed) {
+        // Send the pending report now rather than at the next frame. While waiting for a busy endpoint, a frame may
+        // already have sent it
+        if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
+            if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
+                osalSysUnlock();
+                return;
+            }
+        }
+        if (mouse_report_queued && !usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
+            mouse_transmit_pending(&USB_DRIVER);
+        }
+    }
+
+    if (!mouse_report_queued) {
+        mouse_report_time = mouse_sample_time_set ? mouse_sample_time : chVTGetSystemTimeX();
+    }
+    mouse_sample_time_set = false;
+#        ifdef MOUSE_SHARED_EP
+    mouse_report_pending.report_id = report->report_id;
+#        endif
+    mouse_report_pending.buttons = report->buttons;
+    mouse_report_pending.x       = mouse_coalesce_merge_xy(mouse_report_pending.x, report->x);
+    mouse_report_pending.y       = mouse_coalesce_merge_xy(mouse_report_pending.y, report->y);
+    mouse_report_pending.v       = mouse_coalesce_merge(mouse_report_pending.v, report->v);
+    mouse_report_pending.h       = mouse_coalesce_merge(mouse_report_pending.h, report->h);
+#        ifdef MOUSE_EXTENDED_REPORT
+    mouse_report_pending.boot_x = mouse_coalesce_merge(mouse_report_pending.x, 0);
+    mouse_report_pending.boot_y = mouse_coalesce_merge(mouse_report_pending.y, 0);
+#        endif
+    mouse_report_queued = true;
+    osalSysUnlock();
+}
+#    else
 void send_mouse(report_mouse_t *report) {
     osalSysLock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
@@ -917,6 +1093,7 @@ void send_mouse(report_mouse_t *report) {
     usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
     osalSysUnlock();
 }
+#    endif /* USB_MOUSE_COALESCE */
 
 #else  /* MOUSE_ENABLE */
 void send_mouse(report_mouse_t *report) {
@@ -931,9 +1108,12 @@ void send_mouse(report_mouse_t *report) {
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
     (void)usbp;
     (void)ep;
+#    if defined(LATENCY_TRACE_ENABLE) && (defined(KEYBOARD_SHARED_EP) || defined(NKRO_ENABLE))
+    // Keyboard reports sent through this endpoint cannot be told apart from the others
+    latency_trace_report_delivered();
+#    endif
 }
 #endif
 
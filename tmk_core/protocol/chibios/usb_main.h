@@ -75,6 +75,19 @@ void nkro_in_cb(USBDriver *usbp, usbep_t ep);
 
 /* mouse IN request callback handler */
 void mouse_in_cb(USBDriver *usbp, usbep_t ep);
+
+#    ifdef USB_MOUSE_COALESCE
+#        ifndef USB_MOUSE_LATENCY_BUCKETS
+#            define USB_MOUSE_LATENCY_BUCKETS 16
+#        endif
+
+/* time the oldest motion of the next send_mouse() was sampled, when the driver knows it */
+void usb_mouse_set_sample_time(systime_t time);
+
+/* age of the motion when its report is handed to the endpoint, in USB_MOUSE_LATENCY_BUCKET_US wide buckets (last one
+ * collects the rest) */
+void usb_mouse_latency(uint16_t histogram[USB_MOUSE_LATENCY_BUCKETS], bool reset);
+#    endif /* USB_MOUSE_COALESCE */
 #endif /* MOUSE_ENABLE */
 
 /* ---------------
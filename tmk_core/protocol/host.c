@@ -33,6 +33,7 @@ static host_driver_t *driver;
 static uint16_t       last_system_report              = 0;
 static uint16_t       last_consumer_report            = 0;
 static uint32_t       last_programmable_button_report = 0;
+static uint8_t        mouse_resolution                = 0;
 
 void host_set_driver(host_driver_t *d) {
     driver = d;
@@ -93,10 +94,55 @@ void host_mouse_send(report_mouse_t *report) {
     if (!driver) return;
 #ifdef MOUSE_SHARED_EP
     report->report_id = REPORT_ID_MOUSE;
+#endif
+#ifdef MOUSE_EXTENDED_REPORT
+    // clamp and copy to boot protocol XY
+    report->boot_x = (report->x > 127) ? 127 : ((report->x < -127) ? -127 : report->x);
+    report->boot_y = (report->y > 127) ? 127 : ((report->y < -127) ? -127 : report->y);
 #endif
     (*driver->send_mouse)(report);
 }
 
+/** \brief Stores the Resolution Multiplier feature report set by the host, or 0 to reset it */
+void host_mouse_set_resolution(uint8_t resolution) {
+    mouse_resolution = resolution;
+}
+
+uint8_t host_mouse_get_resolution(void) {
+    return mouse_resolution;
+}
+
+/** \brief Returns the wheel units the host counts as one detent of the vertical wheel */
+uint8_t host_mouse_wheel_multiplier(void) {
+#ifdef MOUSE_HIRES_SCROLL
+    if (mouse_resolution & MOUSE_RESOLUTION_WHEEL) {
+        return MOUSE_HIRES_SCROLL_MULTIPLIER;
+    }
+#endif
+    return 1;
+}
+
+/** \brief Returns the wheel units the host counts as one detent of the horizontal wheel */
+uint8_t host_mouse_pan_multiplier(void) {
+#ifdef MOUSE_HIRES_SCROLL
+    if (mouse_resolution & MOUSE_RESOLUTION_PAN) {
+        return MOUSE_HIRES_SCROLL_MULTIPLIER;
+    }
+#endif
+    return 1;
+}
+
+static int8_t scale_detents(int8_t detents, uint8_t multiplier) {
+    int16_t units = (int16_t)detents * multiplier;
+    return units > 127 ? 127 : (units < -127 ? -127 : units);
+}
+
+/** \brief Turns the wheel motion of a report from whole detents into the wheel units the host counts */
+void host_mouse_scale_detents(report_mouse_t *report) {
+    report->v = scale_detents(report->v, host_mouse_wheel_multiplier());
+    report->h = scale_detents(report->h, host_mouse_pan_multiplier());
+}
+
 void host_system_send(uint16_t report) {
     if (report == last_system_report) return;
     last_system_report = report;
@@ -49,6 +49,12 @@ void    host_system_send(uint16_t data);
 void    host_consumer_send(uint16_t data);
 void    host_programmable_button_send(uint32_t data);
 
+void    host_mouse_set_resolution(uint8_t resolution);
+uint8_t host_mouse_get_resolution(void);
+uint8_t host_mouse_wheel_multiplier(void);
+uint8_t host_mouse_pan_multiplier(void);
+void    host_mouse_scale_detents(report_mouse_t *report);
+
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 uint32_t host_last_programmable_button_report(void);
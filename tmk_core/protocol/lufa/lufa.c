@@ -450,6 +450,11 @@ void EVENT_USB_Device_StartOfFrame(void) {
 void EVENT_USB_Device_ConfigurationChanged(void) {
     bool ConfigSuccess = true;
 
+#ifdef MOUSE_HIRES_SCROLL
+    /* Feature reports return to their defaults until the host sets them again */
+    host_mouse_set_resolution(0);
+#endif
+
 #ifndef KEYBOARD_SHARED_EP
     /* Setup keyboard report endpoint */
     ConfigSuccess &= Endpoint_ConfigureEndpoint((KEYBOARD_IN_EPNUM | ENDPOINT_DIR_IN), EP_TYPE_INTERRUPT, KEYBOARD_EPSIZE, 1);
@@ -541,6 +546,20 @@ void EVENT_USB_Device_ControlRequest(void) {
                         break;
                 }
 
+#ifdef MOUSE_HIRES_SCROLL
+                // Resolution Multiplier, the only feature report
+#    ifdef MOUSE_SHARED_EP
+                uint8_t resolution_report[] = {REPORT_ID_MOUSE, host_mouse_get_resolution()};
+                if ((USB_ControlRequest.wValue >> 8) == HID_REPORT_TYPE_FEATURE && USB_ControlRequest.wIndex == SHARED_INTERFACE) {
+#    else
+                uint8_t resolution_report[] = {host_mouse_get_resolution()};
+                if ((USB_ControlRequest.wValue >> 8) == HID_REPORT_TYPE_FEATURE && USB_ControlRequest.wIndex == MOUSE_INTERFACE) {
+#    endif
+                    ReportData = resolution_report;
+                    ReportSize = sizeof(resolution_report);
+                }
+#endif
+
                 /* Write the report data to the control endpoint */
                 Endpoint_Write_Control_Stream_LE(ReportData, ReportSize);
                 Endpoint_ClearOUT();
@@ -549,6 +568,32 @@ void EVENT_USB_Device_ControlRequest(void) {
             break;
         case HID_REQ_SetReport:
             if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) {
+#ifdef MOUSE_HIRES_SCROLL
+                // Resolution Multiplier, the only feature report
+#    ifdef MOUSE_SHARED_EP
+                if ((USB_ControlRequest.wValue >> 8) == HID_REPORT_TYPE_FEATURE && USB_ControlRequest.wIndex == SHARED_INTERFACE) {
+#    else
+                if ((USB_ControlRequest.wValue >> 8) == HID_REPORT_TYPE_FEATURE && USB_ControlRequest.wIndex == MOUSE_INTERFACE) {
+#    endif
+                    Endpoint_ClearSETUP();
+
+                    while (!(Endpoint_IsOUTReceived())) {
+                        if (USB_DeviceState == DEVICE_STATE_Unattached) return;
+                    }
+
+#    ifdef MOUSE_SHARED_EP
+                    if (Endpoint_Read_8() == REPORT_ID_MOUSE) {
+                        host_mouse_set_resolution(Endpoint_Read_8());
+                    }
+#    else
+                    host_mouse_set_resolution(Endpoint_Read_8());
+#    endif
+
+                    Endpoint_ClearOUT();
+                    Endpoint_ClearStatusStage();
+                    break;
+                }
+#endif
                 // Interface
                 switch (USB_ControlRequest.wIndex) {
                     case KEYBOARD_INTERFACE:
@@ -700,7 +745,11 @@ static void send_mouse(report_mouse_t *report) {
     if (where_to_send() == OUTPUT_BLUETOOTH) {
 #        ifdef BLUETOOTH_BLUEFRUIT_LE
         // FIXME: mouse buttons
+#            ifdef MOUSE_EXTENDED_REPORT
+        bluefruit_le_send_mouse_move(report->boot_x, report->boot_y, report->v, report->h, report->buttons);
+#            else
         bluefruit_le_send_mouse_move(report->x, report->y, report->v, report->h, report->buttons);
+#            endif
 #        elif BLUETOOTH_RN42
         rn42_send_mouse(report);
 #        endif
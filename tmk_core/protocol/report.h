@@ -35,6 +35,9 @@ enum hid_report_ids {
     REPORT_ID_DIGITIZER
 };
 
+/* HID report types, in the high byte of wValue of GET_REPORT and SET_REPORT requests */
+#define HID_REPORT_TYPE_FEATURE 0x03
+
 /* Mouse buttons */
 #define MOUSE_BTN_MASK(n) (1 << (n))
 enum mouse_buttons {
@@ -138,6 +141,32 @@ enum desktop_usages {
 #    endif
 #endif
 
+#ifdef MOUSE_EXTENDED_REPORT
+#    if defined(PROTOCOL_VUSB) || defined(PROTOCOL_ARM_ATSAM)
+#        error "MOUSE_EXTENDED_REPORT is not supported by this protocol"
+#    endif
+typedef int16_t mouse_xy_report_t;
+#    define MOUSE_REPORT_XY_MIN -32767
+#    define MOUSE_REPORT_XY_MAX 32767
+#else
+typedef int8_t mouse_xy_report_t;
+#    define MOUSE_REPORT_XY_MIN -127
+#    define MOUSE_REPORT_XY_MAX 127
+#endif
+
+#ifdef MOUSE_HIRES_SCROLL
+#    if defined(PROTOCOL_VUSB) || defined(PROTOCOL_ARM_ATSAM)
+#        error "MOUSE_HIRES_SCROLL is not supported by this protocol"
+#    endif
+#    ifndef MOUSE_HIRES_SCROLL_MULTIPLIER
+#        define MOUSE_HIRES_SCROLL_MULTIPLIER 120
+#    endif
+#endif
+
+/* Bits of the mouse Resolution Multiplier feature report, set by the host to read the wheels in 1/MOUSE_HIRES_SCROLL_MULTIPLIER detents */
+#define MOUSE_RESOLUTION_WHEEL (1 << 0)
+#define MOUSE_RESOLUTION_PAN (1 << 2)
+
 #ifdef KEYBOARD_SHARED_EP
 #    define KEYBOARD_REPORT_SIZE 9
 #else
@@ -206,10 +235,14 @@ typedef struct {
     uint8_t report_id;
 #endif
     uint8_t buttons;
-    int8_t  x;
-    int8_t  y;
-    int8_t  v;
-    int8_t  h;
+#ifdef MOUSE_EXTENDED_REPORT
+    int8_t boot_x; // x and y clamped for boot protocol hosts, filled in by host_mouse_send()
+    int8_t boot_y;
+#endif
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    int8_t            v;
+    int8_t            h;
 } __attribute__((packed)) report_mouse_t;
 
 typedef struct {
@@ -301,7 +301,11 @@ enum usb_endpoints {
 
 #define KEYBOARD_EPSIZE 8
 #define SHARED_EPSIZE 32
-#define MOUSE_EPSIZE 8
+#ifdef MOUSE_EXTENDED_REPORT
+#    define MOUSE_EPSIZE 16
+#else
+#    define MOUSE_EPSIZE 8
+#endif
 #define RAW_EPSIZE 32
 #define CONSOLE_EPSIZE 32
 #define MIDI_STREAM_EPSIZE 64